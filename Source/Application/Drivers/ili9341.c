@@ -49,6 +49,11 @@ boolean ILI9341_Initialize(void)
     LCDIF_WriteData(REV | ISC(0x02));
     LCDIF_WriteData(NL(0x1D));
 
+#if defined(LCD_LPTE)
+    LCDIF_WriteCommand(ILI9341_TEON);
+    LCDIF_WriteData(0x00);                                                                          // Signal the vertical blanking only
+#endif
+
     LCDIF_WriteCommand(ILI9341_SLPOUT);
     LCDIF_WriteCommand(ILI9341_DISPON);
 
@@ -67,34 +72,27 @@ void ILI9341_ResumeLCD(void)
     LCDIF_WriteCommand(ILI9341_DISPON);
 }
 
-uint32_t *ILI9341_SetOutputWindow(pRECT Rct, uint32_t *Count, uint32_t DataAttr, uint32_t CmdAttr)
+/* Writes the commands into the caller's buffer, returns their count or 0 if the buffer is too small. */
+uint32_t ILI9341_SetOutputWindow(pRECT Rct, uint32_t *Data, uint32_t Size, uint32_t DataAttr, uint32_t CmdAttr)
 {
-    uint32_t *Data = NULL;
-
-    if ((Rct != NULL) && (Count != NULL))
-    {
-        uint32_t i = 0;
-
-        Data = malloc(ILI9341_SETWINCMDSIZE * sizeof(uint32_t));
-        if (Data != NULL)
-        {
-            Data[i++] = LCDIF_COMM(ILI9341_CASET) | CmdAttr;
-            Data[i++] = LCDIF_COMM(CASSH(Rct->l)) | DataAttr;
-            Data[i++] = LCDIF_COMM(CASSL(Rct->l)) | DataAttr;
-            Data[i++] = LCDIF_COMM(CASEH(Rct->r)) | DataAttr;
-            Data[i++] = LCDIF_COMM(CASEL(Rct->r)) | DataAttr;
-
-            Data[i++] = LCDIF_COMM(ILI9341_RASET) | CmdAttr;
-            Data[i++] = LCDIF_COMM(RASSH(Rct->t + ILI9341_ROWSHIFT)) | DataAttr;
-            Data[i++] = LCDIF_COMM(RASSL(Rct->t + ILI9341_ROWSHIFT)) | DataAttr;
-            Data[i++] = LCDIF_COMM(RASEH(Rct->b + ILI9341_ROWSHIFT)) | DataAttr;
-            Data[i++] = LCDIF_COMM(RASEL(Rct->b + ILI9341_ROWSHIFT)) | DataAttr;
-
-            Data[i++] = LCDIF_COMM(ILI9341_RAMWR) | CmdAttr;
-
-            *Count = i;
-        }
-    }
-    return Data;
+    uint32_t i = 0;
+
+    if ((Rct == NULL) || (Data == NULL) || (Size < ILI9341_SETWINCMDSIZE)) return 0;
+
+    Data[i++] = LCDIF_COMM(ILI9341_CASET) | CmdAttr;
+    Data[i++] = LCDIF_COMM(CASSH(Rct->l)) | DataAttr;
+    Data[i++] = LCDIF_COMM(CASSL(Rct->l)) | DataAttr;
+    Data[i++] = LCDIF_COMM(CASEH(Rct->r)) | DataAttr;
+    Data[i++] = LCDIF_COMM(CASEL(Rct->r)) | DataAttr;
+
+    Data[i++] = LCDIF_COMM(ILI9341_RASET) | CmdAttr;
+    Data[i++] = LCDIF_COMM(RASSH(Rct->t + ILI9341_ROWSHIFT)) | DataAttr;
+    Data[i++] = LCDIF_COMM(RASSL(Rct->t + ILI9341_ROWSHIFT)) | DataAttr;
+    Data[i++] = LCDIF_COMM(RASEH(Rct->b + ILI9341_ROWSHIFT)) | DataAttr;
+    Data[i++] = LCDIF_COMM(RASEL(Rct->b + ILI9341_ROWSHIFT)) | DataAttr;
+
+    Data[i++] = LCDIF_COMM(ILI9341_RAMWR) | CmdAttr;
+
+    return i;
 }
 
@@ -139,6 +139,6 @@
 extern boolean ILI9341_Initialize(void);
 extern void ILI9341_SleepLCD(void);
 extern void ILI9341_ResumeLCD(void);
-extern uint32_t *ILI9341_SetOutputWindow(pRECT Rct, uint32_t *Count, uint32_t DataAttr, uint32_t CmdAttr);
+extern uint32_t ILI9341_SetOutputWindow(pRECT Rct, uint32_t *Data, uint32_t Size, uint32_t DataAttr, uint32_t CmdAttr);
 
 #endif /* _ILI9341_H_ */
@@ -26,6 +26,9 @@ boolean APP_Initialize(void)
     do
     {
         if (!GUI_Initialize()) break;
+#if _FILLBENCHMARK_
+        GDI_BenchmarkFill();
+#endif /* _FILLBENCHMARK_ */
 
         BL_TurnOn(true);
 
@@ -32,6 +32,17 @@ void GDI_FillRectangle(TVLINDEX Layer, TRECT Rct, uint32_t Color)
     if (GDI_ANDRectangles(&Rct, &lc->LayerRgn)) GDI_FillRectangleX(lc, &Rct, Color);
 }
 
+/* Fills the rectangle blending it by the alpha channel of Color. */
+void GDI_FillRectangleAlpha(TVLINDEX Layer, TRECT Rct, uint32_t Color)
+{
+    pLCONTEXT lc;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return;
+
+    lc = &LCDScreen.VLayer[Layer];
+    if (GDI_ANDRectangles(&Rct, &lc->LayerRgn)) GDI_FillRectangleAlphaX(lc, &Rct, Color);
+}
+
 void GDI_DrawLine(TVLINDEX Layer, TPOINT P0, TPOINT P1, uint32_t Color)
 {
     if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return;
@@ -41,8 +52,7 @@ void GDI_DrawLine(TVLINDEX Layer, TPOINT P0, TPOINT P1, uint32_t Color)
         TRECT     Rct;
         pLCONTEXT lc;
 
-        Rct.lt = P0;
-        Rct.rb = P1;
+        Rct = Rect(min(P0.x, P1.x), min(P0.y, P1.y), max(P0.x, P1.x), max(P0.y, P1.y));
 
         lc = &LCDScreen.VLayer[Layer];
         if (GDI_ANDRectangles(&Rct, &lc->LayerRgn)) GDI_FillRectangleX(lc, &Rct, Color);
@@ -89,3 +99,85 @@ void GDI_DrawFrame(TVLINDEX Layer, pRECT Client, pRECT Clip, uint32_t Color)
         }
     }
 }
+
+/*
+Copies the SrcRct part of the bitmap (whole bitmap if SrcRct == NULL) to the layer at Pos.
+Clip == NULL - no additional clipping.
+*/
+void GDI_BitBlt(TVLINDEX Layer, TPOINT Pos, pBITMAP Bitmap, pRECT SrcRct, pRECT Clip,
+                TBLTMODE Mode, uint32_t Key)
+{
+    TRECT     SrcArea, DstRect;
+    TPOINT    SrcPt;
+    pLCONTEXT lc;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized ||
+            (Bitmap == NULL) || (Bitmap->Data == NULL)) return;
+
+    SrcArea = Rect(0, 0, Bitmap->Width - 1, Bitmap->Height - 1);
+    if (SrcRct != NULL)
+    {
+        if (!GDI_ANDRectangles(&SrcArea, SrcRct)) return;
+        Pos.x += SrcArea.l - SrcRct->l;
+        Pos.y += SrcArea.t - SrcRct->t;
+    }
+    else if ((SrcArea.r < 0) || (SrcArea.b < 0)) return;
+
+    DstRect = Rect(Pos.x, Pos.y, Pos.x + SrcArea.r - SrcArea.l, Pos.y + SrcArea.b - SrcArea.t);
+
+    lc = &LCDScreen.VLayer[Layer];
+    if (!GDI_ANDRectangles(&DstRect, &lc->LayerRgn) ||
+            ((Clip != NULL) && !GDI_ANDRectangles(&DstRect, Clip))) return;
+
+    SrcPt = Point(SrcArea.l + DstRect.l - Pos.x, SrcArea.t + DstRect.t - Pos.y);
+    GDI_BitBltX(lc, &DstRect, Bitmap, SrcPt, Mode, Key);
+}
+
+/*
+Moves the pixels of the layer by dXY, Region is the destination.
+Rectangles are copied in the order of the movement, so that no source
+is overwritten before it is copied.
+*/
+void GDI_MoveRegion(TVLINDEX Layer, pREGION Region, TPOINT dXY)
+{
+    pLCONTEXT lc;
+    pRECT     Rects;
+    uint32_t  Count, i, Band;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized ||
+            ((dXY.x == 0) && (dXY.y == 0)) || ((Rects = GDI_GetRegionRects(Region, &Count)) == NULL)) return;
+
+    lc = &LCDScreen.VLayer[Layer];
+    for(i = 0; i < Count; i = Band)
+    {
+        uint32_t j, First;
+
+        Band = i;                                                                                   // Rectangles of one band have the same top
+        if (dXY.y > 0)                                                                              // Bands from the bottom
+        {
+            while((Band < Count) && (Rects[Count - 1 - Band].t == Rects[Count - 1 - i].t)) Band++;
+            First = Count - Band;
+        }
+        else
+        {
+            while((Band < Count) && (Rects[Band].t == Rects[i].t)) Band++;
+            First = i;
+        }
+
+        for(j = 0; j < Band - i; j++)
+        {
+            TRECT Dst = Rects[First + ((dXY.x > 0) ? Band - i - 1 - j : j)];                        // Spans from the right when moving right
+            TRECT Src = GDI_GlobalToLocalRct(&Dst, &dXY);
+
+            if (GDI_ANDRectangles(&Src, &lc->LayerRgn))
+            {
+                Dst = GDI_LocalToGlobalRct(&Src, &dXY);
+                if (GDI_ANDRectangles(&Dst, &lc->LayerRgn))
+                {
+                    Src = GDI_GlobalToLocalRct(&Dst, &dXY);
+                    GDI_MoveRectX(lc, &Src, Dst.lt);
+                }
+            }
+        }
+    }
+}
@@ -20,8 +20,12 @@
 #define _GDI_H_
 
 extern void GDI_FillRectangle(TVLINDEX Layer, TRECT Rct, uint32_t Color);
+extern void GDI_FillRectangleAlpha(TVLINDEX Layer, TRECT Rct, uint32_t Color);
 extern void GDI_DrawLine(TVLINDEX Layer, TPOINT P0, TPOINT P1, uint32_t Color);
 extern void GDI_SetPixel(TVLINDEX Layer, TPOINT P, uint32_t Color);
 extern void GDI_DrawFrame(TVLINDEX Layer, pRECT Client, pRECT Clip, uint32_t Color);
+extern void GDI_BitBlt(TVLINDEX Layer, TPOINT Pos, pBITMAP Bitmap, pRECT SrcRct, pRECT Clip,
+                       TBLTMODE Mode, uint32_t Key);
+extern void GDI_MoveRegion(TVLINDEX Layer, pREGION Region, TPOINT dXY);
 
 #endif /* _GDI_H_ */
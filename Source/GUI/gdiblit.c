@@ -0,0 +1,483 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "gdiblit.h"
+
+/*
+Colors of 32-bit pixels are stored as 0xAABBGGRR, RGB888 pixels are stored
+as R, G, B bytes. The color key is compared with the source pixel in the
+format of the bitmap.
+*/
+
+#define ALPHA_TO_A5(a)      (((a) + 4) >> 3)                                                        // 0..255 -> 0..32
+#define ALPHA_TO_A8(a)      ((a) + ((a) >> 7))                                                      // 0..255 -> 0..256
+
+static uint32_t GDI_ReadPixel(TCFORMAT Format, uint8_t *p)
+{
+    switch (Format)
+    {
+    case CF_RGB565:
+        return RGB_8888(*(uint16_t *)p);
+    case CF_RGB888:
+        return 0xFF000000 | p[0] | (p[1] << 8) | (p[2] << 16);
+    case CF_ARGB8888:
+    case CF_PARGB8888:
+        return *(uint32_t *)p;
+    case CF_xRGB8888:
+        return *(uint32_t *)p | 0xFF000000;
+    default:
+        return 0;
+    }
+}
+
+static uint32_t GDI_ReadRawPixel(uint8_t BPP, uint8_t *p)
+{
+    switch (BPP)
+    {
+    case 1:
+        return *p;
+    case 2:
+        return *(uint16_t *)p;
+    case 3:
+        return p[0] | (p[1] << 8) | (p[2] << 16);
+    default:
+        return *(uint32_t *)p;
+    }
+}
+
+static void GDI_WritePixel(TCFORMAT Format, uint8_t *p, uint32_t Color)
+{
+    switch (Format)
+    {
+    case CF_RGB565:
+        *(uint16_t *)p = RGB_565(Color);
+        break;
+    case CF_RGB888:
+        p[0] = Color;
+        p[1] = Color >> 8;
+        p[2] = Color >> 16;
+        break;
+    case CF_ARGB8888:
+    case CF_PARGB8888:
+    case CF_xRGB8888:
+        *(uint32_t *)p = Color;
+        break;
+    default:
+        break;
+    }
+}
+
+static void GDI_BlitRow565From888(uint16_t *d, uint8_t *s, uint32_t Count)
+{
+    while(Count--)
+    {
+        *d++ = ((s[2] & 0xF8) << 8) | ((s[1] & 0xFC) << 3) | (s[0] >> 3);
+        s += 3;
+    }
+}
+
+static void GDI_BlitRow565From8888(uint16_t *d, uint32_t *s, uint32_t Count)
+{
+    if (((uintptr_t)d & 0x02) && Count)                                                             // Align to the word boundary
+    {
+        *d++ = RGB_565(*s);
+        s++;
+        Count--;
+    }
+    while(Count >= 2)                                                                               // Two pixels per store
+    {
+        *(uint32_t *)d = RGB_565(s[0]) | (RGB_565(s[1]) << 16);
+        d += 2;
+        s += 2;
+        Count -= 2;
+    }
+    if (Count) *d = RGB_565(*s);
+}
+
+static void GDI_BlitRow565Key(uint16_t *d, uint16_t *s, uint32_t Count, uint32_t Key)
+{
+    while(Count--)
+    {
+        uint16_t Pixel = *s++;
+
+        if (Pixel != Key) *d = Pixel;
+        d++;
+    }
+}
+
+static void GDI_BlitRow565From8888Key(uint16_t *d, uint32_t *s, uint32_t Count, uint32_t Key)
+{
+    while(Count--)
+    {
+        uint32_t Pixel = *s++;
+
+        if (Pixel != Key) *d = RGB_565(Pixel);
+        d++;
+    }
+}
+
+static void GDI_BlitRow8888Key(uint32_t *d, uint32_t *s, uint32_t Count, uint32_t Key)
+{
+    while(Count--)
+    {
+        uint32_t Pixel = *s++;
+
+        if (Pixel != Key) *d = Pixel;
+        d++;
+    }
+}
+
+static void GDI_BlitRowGeneric(pLCONTEXT lc, uint8_t *d, pBITMAP Bitmap, uint8_t *s, uint32_t Count,
+                               TBLTMODE Mode, uint32_t Key)
+{
+    uint8_t SrcBPP = GDI_GetBitmapBPP(Bitmap);
+
+    while(Count--)
+    {
+        if ((Mode != BM_COLORKEY) || (GDI_ReadRawPixel(SrcBPP, s) != Key))
+            GDI_WritePixel(lc->ColorFormat, d, GDI_ReadPixel(Bitmap->ColorFormat, s));
+        d += lc->BPP;
+        s += SrcBPP;
+    }
+}
+
+static uint32_t GDI_Blend8888(uint32_t d, uint32_t s)
+{
+    uint32_t a  = ALPHA_TO_A8(s >> 24);
+    uint32_t rb = (((s & 0x00FF00FF) * a + (d & 0x00FF00FF) * (256 - a)) >> 8) & 0x00FF00FF;
+    uint32_t g  = (((s & 0x0000FF00) * a + (d & 0x0000FF00) * (256 - a)) >> 8) & 0x0000FF00;
+
+    return rb | g | (((s >> 24) + (((d >> 24) * (256 - a)) >> 8)) << 24);
+}
+
+static uint32_t GDI_BlendPremul8888(uint32_t d, uint32_t s)
+{
+    uint32_t ia = 256 - ALPHA_TO_A8(s >> 24);
+    uint32_t rb = (((d & 0x00FF00FF) * ia) >> 8) & 0x00FF00FF;
+    uint32_t ag = (((d >> 8) & 0x00FF00FF) * ia) & 0xFF00FF00;
+
+    return s + (rb | ag);                                                                           // The source is already scaled by its alpha
+}
+
+static void GDI_BlendRow565(uint16_t *d, uint32_t *s, uint32_t Count)
+{
+    while(Count--)
+    {
+        uint32_t Pixel = *s++;
+        uint32_t a = ALPHA_TO_A5(Pixel >> 24);
+
+        if (a == 32) *d = RGB_565(Pixel);
+        else if (a != 0)
+        {
+            uint32_t c = RGB565_EXPAND(RGB_565(Pixel)) * a + RGB565_EXPAND(*d) * (32 - a) + RGB565_HALF;
+
+            *d = RGB565_PACK((c >> 5) & 0x07E0F81F);
+        }
+        d++;
+    }
+}
+
+static void GDI_BlendRowPremul565(uint16_t *d, uint32_t *s, uint32_t Count)
+{
+    while(Count--)
+    {
+        uint32_t Pixel = *s++;
+        uint32_t a = ALPHA_TO_A5(Pixel >> 24);
+
+        if (a == 32) *d = RGB_565(Pixel);
+        else if (Pixel != 0)
+        {
+            uint32_t g = ((((Pixel >> 8) & 0xFF) * 63 + 128) >> 8) << 5;                            // Rounded, the 5-bit alpha costs green up to 1 LSB
+            uint32_t c = RGB565_EXPAND((RGB_565(Pixel) & ~0x07E0) | g) +
+                         (((RGB565_EXPAND(*d) * (32 - a) + RGB565_HALF) >> 5) & 0x07E0F81F);
+            uint32_t Overflow = c & 0x08010020;
+
+            if (Overflow)                                                                           // Saturate the rounding overflow
+                c |= (Overflow - (Overflow >> 5)) | ((Overflow >> 6) & 0x00200000);
+            *d = RGB565_PACK(c & 0x07E0F81F);
+        }
+        d++;
+    }
+}
+
+static void GDI_BlendRow(pLCONTEXT lc, uint8_t *d, uint32_t *s, uint32_t Count, boolean Premul)
+{
+    switch (lc->ColorFormat)
+    {
+    case CF_RGB565:
+        if (Premul) GDI_BlendRowPremul565((uint16_t *)d, s, Count);
+        else GDI_BlendRow565((uint16_t *)d, s, Count);
+        break;
+    case CF_ARGB8888:
+    case CF_PARGB8888:
+    case CF_xRGB8888:
+    {
+        uint32_t *p = (uint32_t *)d;
+
+        while(Count--)
+        {
+            *p = (Premul) ? GDI_BlendPremul8888(*p, *s) : GDI_Blend8888(*p, *s);
+            p++;
+            s++;
+        }
+    }
+    break;
+    case CF_RGB888:
+        while(Count--)
+        {
+            uint32_t Pixel = GDI_ReadPixel(CF_RGB888, d);
+
+            Pixel = (Premul) ? GDI_BlendPremul8888(Pixel, *s++) : GDI_Blend8888(Pixel, *s++);
+            GDI_WritePixel(CF_RGB888, d, Pixel);
+            d += 3;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+uint8_t GDI_GetBitmapBPP(pBITMAP Bitmap)
+{
+    return ((Bitmap == NULL) || (Bitmap->ColorFormat >= CF_NUM)) ? 0 :
+           CFormatToBPP[Bitmap->ColorFormat];
+}
+
+uint32_t GDI_GetBitmapStride(pBITMAP Bitmap)
+{
+    if (Bitmap == NULL) return 0;
+
+    return (Bitmap->Stride) ? Bitmap->Stride : Bitmap->Width * GDI_GetBitmapBPP(Bitmap);
+}
+
+/* Fills the rectangle blending it with the layer by the alpha channel of Color. */
+void GDI_FillRectangleAlphaX(pLCONTEXT lc, pRECT Rct, uint32_t Color)
+{
+    uint32_t Width, Height, Stride, Alpha = Color >> 24;
+
+    if ((lc == NULL) || (Rct == NULL) || (lc->FrameBuffer == NULL) || (Alpha == 0) ||
+            (Rct->l > Rct->r) || (Rct->t > Rct->b)) return;
+    if ((Alpha == 0xFF) && (lc->ColorFormat != CF_RGB888))                                          // GDI_FillRectangleX has no RGB888 path
+    {
+        GDI_FillRectangleX(lc, Rct, Color);
+        return;
+    }
+
+    Width  = Rct->r - Rct->l + 1;
+    Height = Rct->b - Rct->t + 1;
+    Stride = lc->LayerRgn.r - lc->LayerRgn.l + 1;
+
+    if (lc->ColorFormat == CF_RGB565)
+    {
+        uint16_t *Row = (uint16_t *)GDI_GetPixelPtr(lc, Rct->lt);
+        uint32_t a = ALPHA_TO_A5(Alpha);
+        uint32_t c = RGB565_EXPAND(RGB_565(Color)) * a + RGB565_HALF;                               // Constant part of the blend
+
+        a = 32 - a;
+        while(Height--)
+        {
+            uint16_t *p = Row;
+            uint32_t Count = Width;
+
+            if (((uintptr_t)p & 0x02) && Count)                                                     // Align to the word boundary
+            {
+                *p = RGB565_PACK(((c + RGB565_EXPAND(*p) * a) >> 5) & 0x07E0F81F);
+                p++;
+                Count--;
+            }
+            while(Count >= 2)                                                                       // Two pixels per load and store
+            {
+                uint32_t Pixels = *(uint32_t *)p;
+                uint32_t Lo = ((c + RGB565_EXPAND(Pixels & 0xFFFF) * a) >> 5) & 0x07E0F81F;
+                uint32_t Hi = ((c + RGB565_EXPAND(Pixels >> 16) * a) >> 5) & 0x07E0F81F;
+
+                *(uint32_t *)p = RGB565_PACK(Lo) | ((uint32_t)RGB565_PACK(Hi) << 16);
+                p += 2;
+                Count -= 2;
+            }
+            if (Count) *p = RGB565_PACK(((c + RGB565_EXPAND(*p) * a) >> 5) & 0x07E0F81F);
+            Row += Stride;
+        }
+    }
+    else
+    {
+        uint8_t *Row = GDI_GetPixelPtr(lc, Rct->lt);
+
+        while(Height--)
+        {
+            uint8_t  *p = Row;
+            uint32_t Count = Width;
+
+            while(Count--)
+            {
+                GDI_WritePixel(lc->ColorFormat, p, GDI_Blend8888(GDI_ReadPixel(lc->ColorFormat, p), Color));
+                p += lc->BPP;
+            }
+            Row += Stride * lc->BPP;
+        }
+    }
+}
+
+/* Copies the pixels of Rct to Dst inside the layer, the areas may overlap. */
+void GDI_MoveRectX(pLCONTEXT lc, pRECT Rct, TPOINT Dst)
+{
+    uint32_t Size, Height, Stride;
+    uint8_t  *d, *s;
+
+    if ((lc == NULL) || (Rct == NULL) || (lc->FrameBuffer == NULL) ||
+            (Rct->l > Rct->r) || (Rct->t > Rct->b)) return;
+
+    Size   = (Rct->r - Rct->l + 1) * lc->BPP;
+    Height = Rct->b - Rct->t + 1;
+    Stride = (lc->LayerRgn.r - lc->LayerRgn.l + 1) * lc->BPP;
+    s = GDI_GetPixelPtr(lc, Rct->lt);
+    d = GDI_GetPixelPtr(lc, Dst);
+
+    if (d == s) return;
+    if (Size == Stride)                                                                             // Rows are contiguous, move at once
+    {
+        memmove(d, s, Size * Height);
+        return;
+    }
+    if (Dst.y > Rct->t)                                                                             // Moving down, start from the bottom row
+    {
+        s += (Height - 1) * Stride;
+        d += (Height - 1) * Stride;
+        while(Height--)
+        {
+            memmove(d, s, Size);
+            s -= Stride;
+            d -= Stride;
+        }
+    }
+    else while(Height--)
+        {
+            memmove(d, s, Size);
+            s += Stride;
+            d += Stride;
+        }
+}
+
+/*
+Rct - destination rectangle already clipped to the layer,
+SrcPt - pixel of the bitmap placed at the top left corner of Rct.
+*/
+void GDI_BitBltX(pLCONTEXT lc, pRECT Rct, pBITMAP Bitmap, TPOINT SrcPt,
+                 TBLTMODE Mode, uint32_t Key)
+{
+    uint32_t Width, Height, DstStride, SrcStride;
+    uint8_t  *d, *s, SrcBPP;
+
+    if ((lc == NULL) || (Rct == NULL) || (lc->FrameBuffer == NULL) ||
+            (Bitmap == NULL) || (Bitmap->Data == NULL) ||
+            (Rct->l > Rct->r) || (Rct->t > Rct->b)) return;
+
+    SrcBPP = GDI_GetBitmapBPP(Bitmap);
+    if ((SrcBPP == 0) || (Bitmap->ColorFormat == CF_8IDX)) return;                                  // Palettes are not supported
+
+    Width     = Rct->r - Rct->l + 1;
+    Height    = Rct->b - Rct->t + 1;
+    DstStride = (lc->LayerRgn.r - lc->LayerRgn.l + 1) * lc->BPP;
+    SrcStride = GDI_GetBitmapStride(Bitmap);
+    d = GDI_GetPixelPtr(lc, Rct->lt);
+    s = (uint8_t *)Bitmap->Data + SrcPt.y * SrcStride + SrcPt.x * SrcBPP;
+
+    if (Mode == BM_BLEND)
+    {
+        if ((Bitmap->ColorFormat == CF_ARGB8888) || (Bitmap->ColorFormat == CF_PARGB8888))
+        {
+            while(Height--)
+            {
+                GDI_BlendRow(lc, d, (uint32_t *)s, Width, Bitmap->ColorFormat == CF_PARGB8888);
+                d += DstStride;
+                s += SrcStride;
+            }
+            return;
+        }
+        Mode = BM_COPY;                                                                             // The source is opaque
+    }
+
+    if ((Mode == BM_COPY) &&
+            ((Bitmap->ColorFormat == lc->ColorFormat) ||
+             ((lc->ColorFormat == CF_xRGB8888) && (SrcBPP == 4))))
+    {
+        if ((Width * lc->BPP == DstStride) && (DstStride == SrcStride))                             // Both are contiguous, copy at once
+        {
+            Width *= Height;
+            Height = 1;
+        }
+        while(Height--)
+        {
+            memcpy(d, s, Width * lc->BPP);
+            d += DstStride;
+            s += SrcStride;
+        }
+        return;
+    }
+
+    while(Height--)
+    {
+        switch (lc->ColorFormat)
+        {
+        case CF_RGB565:
+            if (Mode == BM_COPY)
+            {
+                if (Bitmap->ColorFormat == CF_RGB888)
+                {
+                    GDI_BlitRow565From888((uint16_t *)d, s, Width);
+                    break;
+                }
+                else if (SrcBPP == 4)
+                {
+                    GDI_BlitRow565From8888((uint16_t *)d, (uint32_t *)s, Width);
+                    break;
+                }
+            }
+            else if (Bitmap->ColorFormat == CF_RGB565)
+            {
+                GDI_BlitRow565Key((uint16_t *)d, (uint16_t *)s, Width, Key);
+                break;
+            }
+            else if (SrcBPP == 4)
+            {
+                GDI_BlitRow565From8888Key((uint16_t *)d, (uint32_t *)s, Width, Key);
+                break;
+            }
+            GDI_BlitRowGeneric(lc, d, Bitmap, s, Width, Mode, Key);
+            break;
+        case CF_ARGB8888:
+        case CF_PARGB8888:
+        case CF_xRGB8888:
+            if ((Mode == BM_COLORKEY) && (Bitmap->ColorFormat == lc->ColorFormat))
+            {
+                GDI_BlitRow8888Key((uint32_t *)d, (uint32_t *)s, Width, Key);
+                break;
+            }
+            GDI_BlitRowGeneric(lc, d, Bitmap, s, Width, Mode, Key);
+            break;
+        default:
+            GDI_BlitRowGeneric(lc, d, Bitmap, s, Width, Mode, Key);
+            break;
+        }
+        d += DstStride;
+        s += SrcStride;
+    }
+}
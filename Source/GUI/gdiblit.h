@@ -0,0 +1,36 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GDIBLIT_H_
+#define _GDIBLIT_H_
+
+typedef enum tag_BLTMODE
+{
+    BM_COPY,                                                                                        // Copy pixels, the alpha channel is ignored
+    BM_COLORKEY,                                                                                    // Skip pixels equal to the key
+    BM_BLEND                                                                                        // Blend ARGB8888 and PARGB8888 pixels by their alpha
+} TBLTMODE;
+
+extern uint8_t GDI_GetBitmapBPP(pBITMAP Bitmap);
+extern uint32_t GDI_GetBitmapStride(pBITMAP Bitmap);
+extern void GDI_FillRectangleAlphaX(pLCONTEXT lc, pRECT Rct, uint32_t Color);
+extern void GDI_MoveRectX(pLCONTEXT lc, pRECT Rct, TPOINT Dst);
+extern void GDI_BitBltX(pLCONTEXT lc, pRECT Rct, pBITMAP Bitmap, TPOINT SrcPt,
+                        TBLTMODE Mode, uint32_t Key);
+
+#endif /* _GDIBLIT_H_ */
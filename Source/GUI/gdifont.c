@@ -19,102 +19,907 @@
 * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 */
 #include "systemconfig.h"
+#include "tlsf.h"
 #include "gdifont.h"
 
-static pBFC_CHARINFO GDI_GetFontCharInfo(pBFC_FONT Font, uint16_t Symbol)
+/*
+Glyph bitmaps are read as a stream of bits, MSB first in each data unit.
+Row based glyphs start every row at a new unit unless the font is packed.
+*/
+static const uint32_t GlyphNibbleMask[16][2] =                                                      // 4 glyph bits -> 4 RGB565 pixel masks
+{
+    {0x00000000, 0x00000000}, {0x00000000, 0xFFFF0000}, {0x00000000, 0x0000FFFF}, {0x00000000, 0xFFFFFFFF},
+    {0xFFFF0000, 0x00000000}, {0xFFFF0000, 0xFFFF0000}, {0xFFFF0000, 0x0000FFFF}, {0xFFFF0000, 0xFFFFFFFF},
+    {0x0000FFFF, 0x00000000}, {0x0000FFFF, 0xFFFF0000}, {0x0000FFFF, 0x0000FFFF}, {0x0000FFFF, 0xFFFFFFFF},
+    {0xFFFFFFFF, 0x00000000}, {0xFFFFFFFF, 0xFFFF0000}, {0xFFFFFFFF, 0x0000FFFF}, {0xFFFFFFFF, 0xFFFFFFFF}
+};
+
+/*
+The index of a proportional font: symbols below FONT_DIRECTCHARS are found
+directly, the others by binary search over the sorted ranges.
+*/
+#define FONT_DIRECTCHARS    256
+
+typedef struct tag_FONTRANGE
+{
+    uint16_t      FirstChar;
+    uint16_t      LastChar;
+    pBFC_CHARINFO FirstCharInfo;
+} TFONTRANGE, *pFONTRANGE;
+
+typedef struct tag_FONTINDEX
+{
+    pBFC_FONT     Font;
+    uint32_t      RangeCount;
+    pFONTRANGE    Ranges;
+    pBFC_CHARINFO Direct[FONT_DIRECTCHARS];
+} TFONTINDEX, *pFONTINDEX;
+
+static pDLIST       FontIndexes;
+static pFONTINDEX   LastFontIndex;
+static BFC_CHARINFO MonoCharInfo;
+
+static pFONTINDEX GDI_FindFontIndex(pBFC_FONT Font)
+{
+    pDLITEM tmpItem;
+
+    if ((LastFontIndex != NULL) && (LastFontIndex->Font == Font)) return LastFontIndex;
+
+    tmpItem = DL_GetFirstItem(FontIndexes);
+    while(tmpItem != NULL)
+    {
+        pFONTINDEX tmpIndex = (pFONTINDEX)tmpItem->Data;
+
+        if ((tmpIndex != NULL) && (tmpIndex->Font == Font))
+        {
+            LastFontIndex = tmpIndex;
+            return tmpIndex;
+        }
+        tmpItem = DL_GetNextItem(tmpItem);
+    }
+    return NULL;
+}
+
+static pFONTINDEX GDI_CreateFontIndex(pBFC_FONT Font)
 {
     pBFC_FONT_PROP pProp;
-    pBFC_CHARINFO  Result = NULL;
+    pFONTINDEX     Index;
+    uint32_t       i, j;
+
+    if ((FontIndexes == NULL) && ((FontIndexes = DL_Create(0)) == NULL)) return NULL;
+
+    Index = malloc(sizeof(TFONTINDEX));
+    if (Index == NULL) return NULL;
+    memset(Index, 0x00, sizeof(TFONTINDEX));
+    Index->Font = Font;
+
+    for(pProp = (pBFC_FONT_PROP)Font->p.pProp; pProp != NULL; pProp = (pBFC_FONT_PROP)pProp->pNextProp)
+        Index->RangeCount++;
+
+    if (Index->RangeCount)
+    {
+        Index->Ranges = malloc(Index->RangeCount * sizeof(TFONTRANGE));
+        if (Index->Ranges == NULL)
+        {
+            free(Index);
+            return NULL;
+        }
+    }
+
+    i = 0;
+    for(pProp = (pBFC_FONT_PROP)Font->p.pProp; pProp != NULL; pProp = (pBFC_FONT_PROP)pProp->pNextProp)
+    {
+        TFONTRANGE Range = {pProp->FirstChar, pProp->LastChar, (pBFC_CHARINFO)pProp->pFirstCharInfo};
+
+        for(j = i++; (j > 0) && (Index->Ranges[j - 1].FirstChar > Range.FirstChar); j--)            // Keep the ranges sorted
+            Index->Ranges[j] = Index->Ranges[j - 1];
+        Index->Ranges[j] = Range;
+
+        for(j = Range.FirstChar; (j <= Range.LastChar) && (j < FONT_DIRECTCHARS); j++)
+            if (Index->Direct[j] == NULL) Index->Direct[j] = Range.FirstCharInfo + j - Range.FirstChar;
+    }
+
+    if (DL_AddItem(FontIndexes, Index) == NULL)
+    {
+        free(Index->Ranges);
+        free(Index);
+        return NULL;
+    }
+    return Index;
+}
+
+/* Builds the symbol index of the font, so the font does not need it at the first draw. */
+boolean GDI_LoadFont(pBFC_FONT Font)
+{
+    if (Font == NULL) return false;
+    if (Font->FontType & (FONTTYPE_MONO | FONTTYPE_MONO_AA2 | FONTTYPE_MONO_AA4 | FONTTYPE_MONO_AA8))
+        return true;                                                                                // Monospaced fonts are indexed directly
+
+    return (GDI_FindFontIndex(Font) != NULL) || (GDI_CreateFontIndex(Font) != NULL);
+}
+
+void GDI_UnloadFont(pBFC_FONT Font)
+{
+    pFONTINDEX Index;
+
+    if (Font == NULL) return;
+
+    GDI_FlushGlyphCache(Font);
+    if ((Index = GDI_FindFontIndex(Font)) == NULL) return;
+
+    DL_DeleteItemByData(FontIndexes, Index);
+    if (LastFontIndex == Index) LastFontIndex = NULL;
+    free(Index->Ranges);
+    free(Index);
+}
+
+static pBFC_CHARINFO GDI_GetFontCharInfo(pBFC_FONT Font, uint16_t Symbol)
+{
+    pFONTINDEX Index;
+    int32_t    l, r;
 
     if (Font == NULL) return NULL;
 
-    pProp = (pBFC_FONT_PROP)Font->p.pProp;
-    while(pProp != NULL)
+    if (Font->FontType & (FONTTYPE_MONO | FONTTYPE_MONO_AA2 | FONTTYPE_MONO_AA4 | FONTTYPE_MONO_AA8))
+    {
+        pBFC_FONT_MONO pMono = (pBFC_FONT_MONO)Font->p.pMono;
+        uint32_t       UnitSize;
+
+        if ((pMono == NULL) || (Symbol < pMono->FirstChar) || (Symbol > pMono->LastChar)) return NULL;
+
+        UnitSize = (Font->FontType & DATALENGTH_32) ? 4 : (Font->FontType & DATALENGTH_16) ? 2 : 1;
+        MonoCharInfo.Width = pMono->FontWidth;
+        MonoCharInfo.DataSize = pMono->DataSize;
+        MonoCharInfo.p.pData8 = pMono->p.pData8 + (Symbol - pMono->FirstChar) * pMono->DataSize * UnitSize;
+        return &MonoCharInfo;
+    }
+
+    if (((Index = GDI_FindFontIndex(Font)) == NULL) &&
+            ((Index = GDI_CreateFontIndex(Font)) == NULL)) return NULL;
+
+    if (Symbol < FONT_DIRECTCHARS) return Index->Direct[Symbol];
+
+    l = 0;
+    r = Index->RangeCount - 1;
+    while(l <= r)
+    {
+        int32_t m = (l + r) >> 1;
+
+        if (Symbol < Index->Ranges[m].FirstChar) r = m - 1;
+        else if (Symbol > Index->Ranges[m].LastChar) l = m + 1;
+        else return Index->Ranges[m].FirstCharInfo + Symbol - Index->Ranges[m].FirstChar;
+    }
+    return NULL;
+}
+
+static uint32_t GDI_GetFontBPP(pBFC_FONT Font)
+{
+    if (Font->FontType & (FONTTYPE_MONO_AA2 | FONTTYPE_PROP_AA2)) return 2;
+    if (Font->FontType & (FONTTYPE_MONO_AA4 | FONTTYPE_PROP_AA4)) return 4;
+    if (Font->FontType & (FONTTYPE_MONO_AA8 | FONTTYPE_PROP_AA8)) return 8;
+    return 1;
+}
+
+static uint32_t GDI_GetGlyphPixel(pBFC_FONT Font, pBFC_CHARINFO CharInfo, uint32_t x, uint32_t y, uint32_t BPP)
+{
+    uint32_t UnitBits, BitIndex;
+
+    UnitBits = (Font->FontType & DATALENGTH_32) ? 32 : (Font->FontType & DATALENGTH_16) ? 16 : 8;
+    if (Font->FontType & COLUMN_BASED)
+    {
+        BitIndex = (Font->FontType & DATA_PACKED) ? x * Font->FontHeight * BPP :
+                   x * ((Font->FontHeight * BPP + UnitBits - 1) & ~(UnitBits - 1));
+        BitIndex += y * BPP;
+    }
+    else
+    {
+        BitIndex = (Font->FontType & DATA_PACKED) ? y * CharInfo->Width * BPP :
+                   y * ((CharInfo->Width * BPP + UnitBits - 1) & ~(UnitBits - 1));
+        BitIndex += x * BPP;
+    }
+
+    switch (UnitBits)
+    {
+    case 32:
+        return (CharInfo->p.pData32[BitIndex >> 5] >> (32 - BPP - (BitIndex & 0x1F))) & ((1 << BPP) - 1);
+    case 16:
+        return (CharInfo->p.pData16[BitIndex >> 4] >> (16 - BPP - (BitIndex & 0x0F))) & ((1 << BPP) - 1);
+    default:
+        return (CharInfo->p.pData8[BitIndex >> 3] >> (8 - BPP - (BitIndex & 0x07))) & ((1 << BPP) - 1);
+    }
+}
+
+/*
+Colors of the anti-aliased glyph levels for the last used colors.
+With the transparent background every level is blended with the layer
+by its 5-bit alpha instead.
+*/
+typedef struct tag_GLYPHPALETTE
+{
+    uint32_t ForeColor;
+    uint32_t BackColor;
+    uint32_t BPP;
+    boolean  Transparent;
+    uint16_t Color[256];                                                                            // Opaque background
+    uint32_t ForeA[256];                                                                            // Transparent background: expanded fore * alpha
+    uint8_t  Alpha[256];
+} TGLYPHPALETTE, *pGLYPHPALETTE;
+
+static TGLYPHPALETTE GlyphPalette;
+
+static pGLYPHPALETTE GDI_GetGlyphPalette(uint32_t ForeColor, uint32_t BackColor, uint32_t BPP, boolean Transparent)
+{
+    pGLYPHPALETTE Pal = &GlyphPalette;
+    uint32_t      i, MaxLevel = (1 << BPP) - 1;
+    uint32_t      Fore, Back;
+
+    if ((Pal->BPP == BPP) && (Pal->Transparent == Transparent) && (Pal->ForeColor == ForeColor) &&
+            (Transparent || (Pal->BackColor == BackColor))) return Pal;
+
+    Fore = RGB565_EXPAND(RGB_565(ForeColor));
+    Back = RGB565_EXPAND(RGB_565(BackColor));
+    for(i = 0; i <= MaxLevel; i++)
     {
-        if (Symbol < pProp->FirstChar) break;
-        if (Symbol <= pProp->LastChar)
+        uint32_t a = (i * 32 + (MaxLevel >> 1)) / MaxLevel;                                         // 0..32
+
+        Pal->Alpha[i] = a;
+        Pal->ForeA[i] = Fore * a;
+        Pal->Color[i] = RGB565_PACK(((Fore * a + Back * (32 - a)) >> 5) & 0x07E0F81F);
+    }
+    Pal->ForeColor = ForeColor;
+    Pal->BackColor = BackColor;
+    Pal->BPP = BPP;
+    Pal->Transparent = Transparent;
+
+    return Pal;
+}
+
+static void GDI_DrawGlyphAA565(pLCONTEXT lc, pBFC_FONT Font, pBFC_CHARINFO CharInfo, TPOINT Pos,
+                               uint32_t x, uint32_t y, uint32_t dx, uint32_t dy, uint32_t BPP, pGLYPHPALETTE Pal)
+{
+    uint32_t Stride = lc->LayerRgn.r - lc->LayerRgn.l + 1;
+    uint32_t Mask = (1 << BPP) - 1;
+    uint16_t *d = (uint16_t *)GDI_GetPixelPtr(lc, Pos);
+    boolean  ByteRows = !(Font->FontType & (COLUMN_BASED | DATALENGTH_16 | DATALENGTH_32));
+    uint32_t RowBits = (Font->FontType & DATA_PACKED) ? CharInfo->Width * BPP : (CharInfo->Width * BPP + 7) & ~7;
+
+    for(; dy; dy--, y++, d += Stride)
+    {
+        uint32_t BitIndex = y * RowBits + x * BPP;
+        uint32_t i;
+
+        for(i = 0; i < dx; i++, BitIndex += BPP)
         {
-            Result = (pBFC_CHARINFO)pProp->pFirstCharInfo;
-            Result += Symbol - pProp->FirstChar;
-            break;
+            uint32_t Level = (ByteRows) ?
+                             (CharInfo->p.pData8[BitIndex >> 3] >> (8 - BPP - (BitIndex & 0x07))) & Mask :
+                             GDI_GetGlyphPixel(Font, CharInfo, x + i, y, BPP);
+
+            if (!Pal->Transparent) d[i] = Pal->Color[Level];
+            else if (Level == Mask) d[i] = Pal->Color[Level];
+            else if (Level != 0)
+                d[i] = RGB565_PACK(((Pal->ForeA[Level] + RGB565_EXPAND(d[i]) * (32 - Pal->Alpha[Level])) >> 5) &
+                                   0x07E0F81F);
         }
-        else pProp = (pBFC_FONT_PROP)pProp->pNextProp;
     }
-    return Result;
 }
 
-static wchar_t *GDI_GetTextSymbolByXShift(pBFC_CHARINFO *CharInfo, pTEXT Text, int32_t x, uint32_t *DataBitIndex)
+/*
+Expands Count glyph bits starting from BitIndex into RGB565 pixels.
+Fore and Back hold the color in both half-words, Back == NULL - transparent background.
+*/
+static void GDI_ExpandGlyphRow565(uint16_t *d, const uint8_t *Bits, uint32_t BitIndex, uint32_t Count,
+                                  uint32_t Fore, uint32_t *Back)
 {
-    wchar_t  *p;
-    uint32_t tmpX = 0;
+    while(Count && (BitIndex & 0x03))                                                               // Up to the nibble boundary
+    {
+        if ((Bits[BitIndex >> 3] << (BitIndex & 0x07)) & 0x80) *d = Fore;
+        else if (Back != NULL) *d = *Back;
+        d++;
+        BitIndex++;
+        Count--;
+    }
+    while(Count >= 4)
+    {
+        uint32_t Nibble = (Bits[BitIndex >> 3] >> (4 - (BitIndex & 0x04))) & 0x0F;
+
+        if (Back != NULL)
+        {
+            uint32_t w0 = (Fore & GlyphNibbleMask[Nibble][0]) | (*Back & ~GlyphNibbleMask[Nibble][0]);
+            uint32_t w1 = (Fore & GlyphNibbleMask[Nibble][1]) | (*Back & ~GlyphNibbleMask[Nibble][1]);
 
-    if ((Text == NULL) || (Text->Font == NULL) || (Text->Text == NULL)) return NULL;
-    if (x < 0) x = 0;
+            if ((uintptr_t)d & 0x02)
+            {
+                d[0] = w0;
+                d[1] = w0 >> 16;
+                d[2] = w1;
+                d[3] = w1 >> 16;
+            }
+            else
+            {
+                ((uint32_t *)d)[0] = w0;
+                ((uint32_t *)d)[1] = w1;
+            }
+        }
+        else if (Nibble == 0x0F)
+        {
+            d[0] = d[1] = d[2] = d[3] = Fore;
+        }
+        else if (Nibble)
+        {
+            if (Nibble & 0x08) d[0] = Fore;
+            if (Nibble & 0x04) d[1] = Fore;
+            if (Nibble & 0x02) d[2] = Fore;
+            if (Nibble & 0x01) d[3] = Fore;
+        }
+        d += 4;
+        BitIndex += 4;
+        Count -= 4;
+    }
+    while(Count--)
+    {
+        if ((Bits[BitIndex >> 3] << (BitIndex & 0x07)) & 0x80) *d = Fore;
+        else if (Back != NULL) *d = *Back;
+        d++;
+        BitIndex++;
+    }
+}
+
+static void GDI_DrawGlyph565(pLCONTEXT lc, pBFC_FONT Font, pBFC_CHARINFO CharInfo, TPOINT Pos,
+                             uint32_t x, uint32_t y, uint32_t dx, uint32_t dy, uint32_t Fore, uint32_t *Back)
+{
+    uint32_t Stride = lc->LayerRgn.r - lc->LayerRgn.l + 1;
+    uint16_t *d = (uint16_t *)GDI_GetPixelPtr(lc, Pos);
 
-    p = Text->Text;
-    while(*p)
+    if (!(Font->FontType & (COLUMN_BASED | DATALENGTH_16 | DATALENGTH_32)))                         // Byte rows, expand by nibbles
     {
-        pBFC_CHARINFO tmpCharInfo = GDI_GetFontCharInfo(Text->Font, *p);
+        uint32_t RowBits = (Font->FontType & DATA_PACKED) ? CharInfo->Width : (CharInfo->Width + 7) & ~7;
 
-        if (tmpCharInfo != NULL)
+        for(; dy; dy--, y++, d += Stride)
+            GDI_ExpandGlyphRow565(d, CharInfo->p.pData8, y * RowBits + x, dx, Fore, Back);
+    }
+    else
+    {
+        for(; dy; dy--, y++, d += Stride)
         {
-            if ((x >= tmpX) && (x < (tmpX + tmpCharInfo->Width)))
+            uint32_t i;
+
+            for(i = 0; i < dx; i++)
             {
-                if (DataBitIndex != NULL) *DataBitIndex = x - tmpX;
-                if (CharInfo != NULL)     *CharInfo = tmpCharInfo;
-                return p;
+                if (GDI_GetGlyphPixel(Font, CharInfo, x + i, y, 1)) d[i] = Fore;
+                else if (Back != NULL) d[i] = *Back;
             }
-            tmpX += tmpCharInfo->Width;
         }
-        p++;
     }
-    return NULL;
 }
 
-pDLIST GDI_DrawText565(TVLINDEX Layer, pTEXT Text, pRECT Client, pRECT Clip,
-                       uint32_t ForeColor, uint32_t BackColor, int16_t TextDX, int16_t TextDY)
+/*
+Glyphs of opaque text are kept pre-rendered for the used (font, symbol, colors)
+in a separate pool, so the repeated text is drawn by copying. The least
+recently used glyphs are evicted when the pool or the set limit is exhausted.
+*/
+#define GLYPHCACHE_HASHSIZE 64
+
+typedef struct tag_GLYPHCACHEITEM *pGLYPHCACHEITEM;
+typedef struct tag_GLYPHCACHEITEM
+{
+    pGLYPHCACHEITEM HashNext;
+    pGLYPHCACHEITEM Prev;                                                                           // LRU list, the head is the most recently used
+    pGLYPHCACHEITEM Next;
+    pBFC_FONT       Font;
+    uint32_t        Symbol;
+    uint32_t        ForeColor;
+    uint32_t        BackColor;
+    uint32_t        Size;                                                                           // Bytes of the item with its pixels
+    TBITMAP         Bitmap;
+} TGLYPHCACHEITEM;
+
+static uint8_t          GlyphCachePool[GlyphCacheSize] __attribute__ ((aligned (8), section (".noinit")));
+static boolean          GlyphCacheReady;
+static pGLYPHCACHEITEM  GlyphCacheHash[GLYPHCACHE_HASHSIZE];
+static pGLYPHCACHEITEM  GlyphCacheHead, GlyphCacheTail;
+static TGLYPHCACHESTAT  GlyphCacheStat = {0, 0, 0, 0, 0, GlyphCacheSize};
+
+static uint32_t GDI_GlyphCacheHash(pBFC_FONT Font, uint32_t Symbol, uint32_t ForeColor, uint32_t BackColor)
+{
+    uint32_t h = ((uintptr_t)Font >> 2) ^ (Symbol * 0x9E3779B1) ^ ForeColor ^ (BackColor * 7);
+
+    return (h ^ (h >> 16)) & (GLYPHCACHE_HASHSIZE - 1);
+}
+
+static void GDI_UnlinkCachedGlyph(pGLYPHCACHEITEM Item)
 {
-    uint16_t *FrameBuffer;
-    int32_t  FrameWidth;
-    int16_t  XShift, YShift;
-    TRECT    tmpRect, tmpClient;
-    pDLIST   BorderRects = NULL;
+    if (Item->Prev != NULL) Item->Prev->Next = Item->Next;
+    else GlyphCacheHead = Item->Next;
+    if (Item->Next != NULL) Item->Next->Prev = Item->Prev;
+    else GlyphCacheTail = Item->Prev;
+}
 
-    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized ||
-            (LCDScreen.VLayer[Layer].ColorFormat != CF_RGB565))
-        return NULL;
+static void GDI_LinkCachedGlyph(pGLYPHCACHEITEM Item)
+{
+    Item->Prev = NULL;
+    Item->Next = GlyphCacheHead;
+    if (GlyphCacheHead != NULL) GlyphCacheHead->Prev = Item;
+    else GlyphCacheTail = Item;
+    GlyphCacheHead = Item;
+}
+
+static void GDI_DeleteCachedGlyph(pGLYPHCACHEITEM Item)
+{
+    pGLYPHCACHEITEM *pHash = &GlyphCacheHash[GDI_GlyphCacheHash(Item->Font, Item->Symbol,
+                                                                Item->ForeColor, Item->BackColor)];
+
+    while((*pHash != NULL) && (*pHash != Item)) pHash = &(*pHash)->HashNext;
+    if (*pHash != NULL) *pHash = Item->HashNext;
+
+    GDI_UnlinkCachedGlyph(Item);
+    GlyphCacheStat.Used -= Item->Size;
+    GlyphCacheStat.Count--;
+    free_ex(Item, GlyphCachePool);
+}
+
+static pBITMAP GDI_GetCachedGlyph(pBFC_FONT Font, pBFC_CHARINFO CharInfo, uint32_t Symbol,
+                                  uint32_t ForeColor, uint32_t BackColor, uint32_t BPP, pGLYPHPALETTE Pal)
+{
+    pGLYPHCACHEITEM Item;
+    TLCONTEXT       GlyphContext = {0};
+    uint32_t        Hash, Size;
 
-    if ((Client != NULL) && (Clip != NULL))
+    if (!GlyphCacheReady)
     {
-        tmpClient = *Client;
-        if (!GDI_ANDRectangles(&tmpClient, &LCDScreen.VLayer[Layer].LayerRgn) ||
-                !GDI_ANDRectangles(&tmpClient, Clip))
-            return NULL;
-        BorderRects = DL_Create(0);
-        GDI_ADDRectToRegion(BorderRects, &tmpClient);
+        if (init_memory_pool(GlyphCacheSize, GlyphCachePool) == (size_t)-1) return NULL;
+        GlyphCacheReady = true;
+    }
+
+    Hash = GDI_GlyphCacheHash(Font, Symbol, ForeColor, BackColor);
+    for(Item = GlyphCacheHash[Hash]; Item != NULL; Item = Item->HashNext)
+    {
+        if ((Item->Font == Font) && (Item->Symbol == Symbol) &&
+                (Item->ForeColor == ForeColor) && (Item->BackColor == BackColor))
+        {
+            if (Item != GlyphCacheHead)
+            {
+                GDI_UnlinkCachedGlyph(Item);
+                GDI_LinkCachedGlyph(Item);
+            }
+            GlyphCacheStat.Hits++;
+            return &Item->Bitmap;
+        }
     }
-    else return NULL;
+    GlyphCacheStat.Misses++;
 
-    FrameBuffer = LCDScreen.VLayer[Layer].FrameBuffer;
-    FrameWidth  = LCDScreen.VLayer[Layer].LayerRgn.r - LCDScreen.VLayer[Layer].LayerRgn.l + 1;
-    ForeColor = RGB_565(ForeColor);
-    BackColor = RGB_565(BackColor);
+    Size = sizeof(TGLYPHCACHEITEM) + CharInfo->Width * Font->FontHeight * sizeof(uint16_t);
+    if ((CharInfo->Width == 0) || (Size > GlyphCacheStat.Limit)) return NULL;
+
+    while((GlyphCacheTail != NULL) && (GlyphCacheStat.Used + Size > GlyphCacheStat.Limit))
+    {
+        GDI_DeleteCachedGlyph(GlyphCacheTail);
+        GlyphCacheStat.Evictions++;
+    }
+    while((Item = malloc_ex(Size, GlyphCachePool)) == NULL)                                         // The pool may be fragmented
+    {
+        if (GlyphCacheTail == NULL) return NULL;
+        GDI_DeleteCachedGlyph(GlyphCacheTail);
+        GlyphCacheStat.Evictions++;
+    }
 
-    if ((Text != NULL) && (Text->Font != NULL) && (Text->Text != NULL))
+    Item->Font = Font;
+    Item->Symbol = Symbol;
+    Item->ForeColor = ForeColor;
+    Item->BackColor = BackColor;
+    Item->Size = Size;
+    Item->Bitmap.ColorFormat = CF_RGB565;
+    Item->Bitmap.Width = CharInfo->Width;
+    Item->Bitmap.Height = Font->FontHeight;
+    Item->Bitmap.Stride = 0;
+    Item->Bitmap.Data = &Item[1];
+
+    GlyphContext.Initialized = true;
+    GlyphContext.LayerRgn = Rect(0, 0, CharInfo->Width - 1, Font->FontHeight - 1);
+    GlyphContext.BPP = 2;
+    GlyphContext.ColorFormat = CF_RGB565;
+    GlyphContext.FrameBuffer = Item->Bitmap.Data;
+    if (BPP == 1)
     {
-        switch (Text->Align & AH_MASK)
+        uint32_t Fore = RGB_565(ForeColor) * 0x00010001;
+        uint32_t Back = RGB_565(BackColor) * 0x00010001;
+
+        GDI_DrawGlyph565(&GlyphContext, Font, CharInfo, Point(0, 0), 0, 0,
+                         CharInfo->Width, Font->FontHeight, Fore, &Back);
+    }
+    else GDI_DrawGlyphAA565(&GlyphContext, Font, CharInfo, Point(0, 0), 0, 0,
+                                CharInfo->Width, Font->FontHeight, BPP, Pal);
+
+    Item->HashNext = GlyphCacheHash[Hash];
+    GlyphCacheHash[Hash] = Item;
+    GDI_LinkCachedGlyph(Item);
+    GlyphCacheStat.Used += Size;
+    GlyphCacheStat.Count++;
+
+    return &Item->Bitmap;
+}
+
+/* Font == NULL - flush all glyphs */
+void GDI_FlushGlyphCache(pBFC_FONT Font)
+{
+    pGLYPHCACHEITEM Item = GlyphCacheHead;
+
+    while(Item != NULL)
+    {
+        pGLYPHCACHEITEM Next = Item->Next;
+
+        if ((Font == NULL) || (Item->Font == Font)) GDI_DeleteCachedGlyph(Item);
+        Item = Next;
+    }
+}
+
+/* Limits the memory used by the glyph cache, the limit can not exceed GlyphCacheSize */
+void GDI_SetGlyphCacheLimit(uint32_t Limit)
+{
+    GlyphCacheStat.Limit = min(Limit, GlyphCacheSize);
+    while((GlyphCacheTail != NULL) && (GlyphCacheStat.Used > GlyphCacheStat.Limit))
+    {
+        GDI_DeleteCachedGlyph(GlyphCacheTail);
+        GlyphCacheStat.Evictions++;
+    }
+}
+
+void GDI_GetGlyphCacheStat(pGLYPHCACHESTAT Stat)
+{
+    if (Stat != NULL) *Stat = GlyphCacheStat;
+}
+
+TSIZEXY GDI_GetTextExtent(pBFC_FONT Font, wchar_t *Text)
+{
+    TSIZEXY Extent = {0, 0};
+
+    if ((Font == NULL) || (Text == NULL)) return Extent;
+
+    Extent.sy = Font->FontHeight;
+    while(*Text)
+    {
+        pBFC_CHARINFO CharInfo = GDI_GetFontCharInfo(Font, *Text++);
+
+        if (CharInfo != NULL) Extent.sx += CharInfo->Width;
+    }
+    return Extent;
+}
+
+static const wchar_t EllipsisSymbol[] = {0x2026, 0};
+static const wchar_t EllipsisDots[]   = {'.', '.', '.', 0};
+
+static uint32_t GDI_GetAdvance(pTEXT Text, uint32_t Index)                                          // x of the symbol start
+{
+    return (Index) ? Text->Advances[Index - 1] : 0;
+}
+
+static boolean GDI_AddTextLine(pTEXT Text, uint32_t Start, uint32_t End, boolean Ellipsis)
+{
+    pTEXTLINE Line;
+
+    if (Text->LineCount >= Text->LinesSize)
+    {
+        pTEXTLINE NewLines = realloc(Text->Lines, (Text->LinesSize + 4) * sizeof(TTEXTLINE));
+
+        if (NewLines == NULL) return false;
+        Text->Lines = NewLines;
+        Text->LinesSize += 4;
+    }
+    Line = &Text->Lines[Text->LineCount++];
+    Line->Start = Start;
+    Line->Length = End - Start;
+    Line->Width = GDI_GetAdvance(Text, End) - GDI_GetAdvance(Text, Start);
+    Line->Ellipsis = Ellipsis;
+    if (Ellipsis) Line->Width += Text->EllipsisWidth;
+
+    if (Line->Width > Text->Extent.sx) Text->Extent.sx = Line->Width;
+    Text->Extent.sy += Text->Font->FontHeight;
+
+    return true;
+}
+
+/* Splits the text into lines by '\n', by the width and by the number of lines. */
+static boolean GDI_BreakTextLines(pTEXT Text)
+{
+    uint32_t i = 0;
+    boolean  Limited = (Text->MaxWidth > 0);
+
+    Text->LineCount = 0;
+    Text->Extent.sx = Text->Extent.sy = 0;
+
+    while(true)
+    {
+        uint32_t Start = i, Base = GDI_GetAdvance(Text, i), End;
+        int32_t  Break = -1;
+        boolean  LastLine = (Text->MaxLines != 0) && (Text->LineCount + 1 >= Text->MaxLines);
+        boolean  Ellipsis = false;
+
+        while((i < Text->Length) && (Text->Text[i] != '\n'))
         {
-        case AH_RIGHT:
-            XShift = Client->r - Text->Extent.sx - Client->l + 1;
-            break;
-        case AH_CENTER:
-            XShift = (Client->r - Client->l - Text->Extent.sx + 1) / 2;
-            break;
-        case AH_LEFT:
-        default:
-            XShift = 0;
-            break;
+            if (Limited && (Text->Advances[i] - Base > (uint32_t)Text->MaxWidth) && (i > Start)) break;
+            if (Text->Text[i] == ' ') Break = i;
+            i++;
+        }
+        End = i;
+
+        if ((i < Text->Length) && (Text->Text[i] != '\n'))                                          // The line is wider than MaxWidth
+        {
+            if ((Text->Flags & TXF_WORDWRAP) && !LastLine)
+            {
+                if (Break > (int32_t)Start)                                                         // Break at the last space
+                {
+                    End = Break;
+                    i = Break + 1;
+                }
+                while((i < Text->Length) && (Text->Text[i] == ' ')) i++;
+                while((End > Start) && (Text->Text[End - 1] == ' ')) End--;
+                if (!GDI_AddTextLine(Text, Start, End, false)) return false;
+                continue;
+            }
+            while((i < Text->Length) && (Text->Text[i] != '\n')) i++;                               // The rest of the line is dropped
+            Ellipsis = (Text->Flags & TXF_ELLIPSIS) != 0;
+        }
+        if (LastLine && (i < Text->Length)) Ellipsis = (Text->Flags & TXF_ELLIPSIS) != 0;
+
+        if (Ellipsis && Limited)                                                                    // Leave the space for the ellipsis
+        {
+            while((End > Start) && (GDI_GetAdvance(Text, End) - Base + Text->EllipsisWidth > (uint32_t)Text->MaxWidth))
+                End--;
+        }
+        if (!GDI_AddTextLine(Text, Start, End, Ellipsis)) return false;
+
+        if (LastLine || (i >= Text->Length)) break;
+        i++;                                                                                        // Skip '\n'
+    }
+    return true;
+}
+
+/*
+Calculates the advances of the symbols, the lines and the extent of the text,
+if they are not calculated yet. Returns false if the layout is not available.
+*/
+boolean GDI_UpdateTextLayout(pTEXT Text)
+{
+    uint32_t Length, i, x = 0;
+
+    if ((Text == NULL) || (Text->Font == NULL) || (Text->Text == NULL)) return false;
+    if (Text->LayoutValid) return true;
+
+    for(Length = 0; Text->Text[Length]; Length++);
+    if (Length > Text->AdvancesSize)
+    {
+        uint16_t *NewAdvances = realloc(Text->Advances, Length * sizeof(uint16_t));
+
+        if (NewAdvances == NULL) return false;
+        Text->Advances = NewAdvances;
+        Text->AdvancesSize = Length;
+    }
+    Text->Length = Length;
+
+    for(i = 0; i < Length; i++)
+    {
+        pBFC_CHARINFO CharInfo = GDI_GetFontCharInfo(Text->Font, Text->Text[i]);
+
+        if ((CharInfo != NULL) && (Text->Text[i] != '\n')) x += CharInfo->Width;
+        Text->Advances[i] = x;
+    }
+
+    if (GDI_GetFontCharInfo(Text->Font, EllipsisSymbol[0]) != NULL)
+    {
+        Text->EllipsisText = EllipsisSymbol;
+        Text->EllipsisLength = sizeof(EllipsisSymbol) / sizeof(EllipsisSymbol[0]) - 1;
+    }
+    else
+    {
+        Text->EllipsisText = EllipsisDots;
+        Text->EllipsisLength = sizeof(EllipsisDots) / sizeof(EllipsisDots[0]) - 1;
+    }
+    Text->EllipsisWidth = GDI_GetTextExtent(Text->Font, (wchar_t *)Text->EllipsisText).sx;
+
+    Text->LayoutValid = GDI_BreakTextLines(Text);
+
+    return Text->LayoutValid;
+}
+
+void GDI_FreeTextLayout(pTEXT Text)
+{
+    if (Text == NULL) return;
+
+    free(Text->Advances);
+    free(Text->Lines);
+    Text->Advances = NULL;
+    Text->Lines = NULL;
+    Text->AdvancesSize = Text->LinesSize = 0;
+    Text->Length = Text->LineCount = 0;
+    Text->LayoutValid = false;
+}
+
+pTEXT GDI_CreateText(pBFC_FONT Font, wchar_t *String, TTEXTALIGN Align,
+                     TTEXTFLAGS Flags, int16_t MaxWidth, uint16_t MaxLines)
+{
+    pTEXT Text = malloc(sizeof(TTEXT));
+
+    if (Text != NULL)
+    {
+        memset(Text, 0x00, sizeof(TTEXT));
+        Text->Font = Font;
+        Text->Align = Align;
+        Text->Flags = Flags;
+        Text->MaxWidth = MaxWidth;
+        Text->MaxLines = MaxLines;
+        if (!GDI_SetTextString(Text, String))
+        {
+            free(Text);
+            Text = NULL;
         }
+    }
+    return Text;
+}
+
+void GDI_DestroyText(pTEXT Text)
+{
+    if (Text == NULL) return;
+
+    GDI_FreeTextLayout(Text);
+    free(Text->Text);
+    free(Text);
+}
+
+/* The string is copied to the text object. */
+boolean GDI_SetTextString(pTEXT Text, wchar_t *String)
+{
+    wchar_t  *NewString;
+    uint32_t Length;
+
+    if (Text == NULL) return false;
+    if (String == NULL) String = L"";
+
+    if (Text->Text != NULL)
+    {
+        wchar_t *a = Text->Text, *b = String;
+
+        while(*a && (*a == *b))
+        {
+            a++;
+            b++;
+        }
+        if (*a == *b) return true;                                                                  // Not changed, keep the layout
+    }
+
+    for(Length = 0; String[Length]; Length++);
+    NewString = malloc((Length + 1) * sizeof(wchar_t));
+    if (NewString == NULL) return false;
+    memcpy(NewString, String, (Length + 1) * sizeof(wchar_t));
+
+    free(Text->Text);
+    Text->Text = NewString;
+    Text->LayoutValid = false;
+
+    return true;
+}
+
+void GDI_SetTextFont(pTEXT Text, pBFC_FONT Font)
+{
+    if ((Text == NULL) || (Text->Font == Font)) return;
+
+    Text->Font = Font;
+    Text->LayoutValid = false;
+}
+
+void GDI_SetTextWidth(pTEXT Text, int16_t MaxWidth)
+{
+    if ((Text == NULL) || (Text->MaxWidth == MaxWidth)) return;
+
+    Text->MaxWidth = MaxWidth;
+    Text->LayoutValid = false;
+}
+
+typedef struct tag_GLYPHDRAW
+{
+    pLCONTEXT     lc;
+    pBFC_FONT     Font;
+    uint32_t      ForeColor;
+    uint32_t      BackColor;
+    uint32_t      Fore;
+    uint32_t      Back;
+    uint32_t      BPP;
+    pGLYPHPALETTE Pal;
+    boolean       Transparent;
+} TGLYPHDRAW, *pGLYPHDRAW;
+
+/*
+Draws up to Count symbols starting from the column x of the first glyph.
+Pos and dx are advanced by the drawn pixels.
+*/
+static void GDI_DrawGlyphRun565(pGLYPHDRAW gd, const wchar_t *Symbols, uint32_t Count, uint32_t x,
+                                pPOINT Pos, uint32_t PixY, uint32_t *dx, uint32_t dy)
+{
+    while(Count-- && *dx)
+    {
+        uint32_t      Symbol = *Symbols++;
+        pBFC_CHARINFO CharInfo = GDI_GetFontCharInfo(gd->Font, Symbol);
+        uint32_t      GlyphDX;
+        pBITMAP       Glyph;
+
+        if ((CharInfo == NULL) || (Symbol == '\n') || (x >= CharInfo->Width))
+        {
+            if (CharInfo != NULL) x -= min(x, CharInfo->Width);
+            continue;
+        }
+
+        GlyphDX = min(CharInfo->Width - x, *dx);
+        Glyph = (gd->Transparent) ? NULL :
+                GDI_GetCachedGlyph(gd->Font, CharInfo, Symbol, gd->ForeColor, gd->BackColor, gd->BPP, gd->Pal);
+
+        if (Glyph != NULL)
+        {
+            TRECT GlyphRect = Rect(Pos->x, Pos->y, Pos->x + GlyphDX - 1, Pos->y + dy - 1);
+
+            GDI_BitBltX(gd->lc, &GlyphRect, Glyph, Point(x, PixY), BM_COPY, 0);
+        }
+        else if (gd->BPP == 1)
+            GDI_DrawGlyph565(gd->lc, gd->Font, CharInfo, *Pos, x, PixY, GlyphDX, dy,
+                             gd->Fore, (gd->Transparent) ? NULL : &gd->Back);
+        else GDI_DrawGlyphAA565(gd->lc, gd->Font, CharInfo, *Pos, x, PixY, GlyphDX, dy, gd->BPP, gd->Pal);
+
+        Pos->x += GlyphDX;
+        *dx -= GlyphDX;
+        x = 0;
+    }
+}
+
+/* Finds the first symbol of the line visible at x, x becomes the column in its glyph. */
+static uint32_t GDI_GetLineSymbolByXShift(pTEXT Text, pTEXTLINE Line, uint32_t *x)
+{
+    uint32_t Base = GDI_GetAdvance(Text, Line->Start);
+    int32_t  l = Line->Start, r = Line->Start + Line->Length;
+
+    if ((Line->Length == 0) || (*x + Base >= Text->Advances[r - 1]))                                // Beyond the symbols
+    {
+        *x -= min(*x, GDI_GetAdvance(Text, r) - Base);
+        return r;
+    }
+    while(l < r)
+    {
+        int32_t m = (l + r) >> 1;
+
+        if (Text->Advances[m] > *x + Base) r = m;
+        else l = m + 1;
+    }
+    *x += Base - GDI_GetAdvance(Text, l);
+    return l;
+}
+
+/*
+The part of the clipped client area not covered by the text is filled with BackColor,
+BackColor with zero alpha leaves the background untouched.
+BorderRgn (may be NULL) receives this uncovered part.
+Returns false if there is nothing to draw.
+*/
+boolean GDI_DrawText565(TVLINDEX Layer, pTEXT Text, pRECT Client, pRECT Clip,
+                        uint32_t ForeColor, uint32_t BackColor, int16_t TextDX, int16_t TextDY,
+                        pREGION BorderRgn)
+{
+    pLCONTEXT lc;
+    TREGION   tmpBorderRgn = {0};
+    TRECT     tmpClient;
+    boolean   Transparent = (BackColor >> 24) == 0;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized ||
+            (LCDScreen.VLayer[Layer].ColorFormat != CF_RGB565) ||
+            (Client == NULL) || (Clip == NULL)) return false;
+
+    lc = &LCDScreen.VLayer[Layer];
+    tmpClient = *Client;
+    if (!GDI_ANDRectangles(&tmpClient, &lc->LayerRgn) || !GDI_ANDRectangles(&tmpClient, Clip)) return false;
+
+    if (BorderRgn == NULL) BorderRgn = &tmpBorderRgn;
+    GDI_SetRegionRect(BorderRgn, &tmpClient);
+
+    if (GDI_UpdateTextLayout(Text))
+    {
+        TGLYPHDRAW gd;
+        int16_t    YShift;
+        uint32_t   i;
 
         switch (Text->Align & AV_MASK)
         {
@@ -129,43 +934,81 @@ pDLIST GDI_DrawText565(TVLINDEX Layer, pTEXT Text, pRECT Client, pRECT Clip,
             YShift = 0;
             break;
         }
-
-        XShift += TextDX;
         YShift += TextDY;
 
-        tmpRect = Rect(0 + Client->l + XShift,
-                       0 + Client->t + YShift,
-                       Text->Extent.sx - 1 + Client->l + XShift,
-                       Text->Extent.sy - 1 + Client->t + YShift);
-
-        if (GDI_ANDRectangles(&tmpRect, &tmpClient))
+        gd.lc = lc;
+        gd.Font = Text->Font;
+        gd.ForeColor = ForeColor;
+        gd.BackColor = BackColor;
+        gd.Fore = RGB_565(ForeColor) * 0x00010001;
+        gd.Back = RGB_565(BackColor) * 0x00010001;
+        gd.BPP = GDI_GetFontBPP(Text->Font);
+        gd.Pal = (gd.BPP > 1) ? GDI_GetGlyphPalette(ForeColor, BackColor, gd.BPP, Transparent) : NULL;
+        gd.Transparent = Transparent;
+
+        for(i = 0; i < Text->LineCount; i++)
         {
-            uint16_t      PixX, PixY, dx, dy, BitStartIndex;
-            pBFC_CHARINFO CharInfo;
-            wchar_t       *CapPtr;
+            pTEXTLINE Line = &Text->Lines[i];
+            TRECT     LineRect, tmpRect;
+            int16_t   XShift, LineTop = Client->t + YShift + i * Text->Font->FontHeight;
+            uint32_t  PixX, PixY, dx, dy, Index;
+            TPOINT    Pos;
 
-            if (!GDI_SUBRectFromRegion(BorderRects, &tmpRect))
-                BorderRects = DL_Delete(BorderRects, false);
+            if (LineTop > tmpClient.b) break;
 
-            PixX = tmpRect.l - Client->l;                                                           // Pixel X shift at client
-            PixY = tmpRect.t - Client->t;                                                           // Pixel Y shift at client
-            dx   = tmpRect.r - tmpRect.l + 1;                                                       // X pixels to draw
-            dy   = tmpRect.b - tmpRect.t + 1;                                                       // Y pixels to draw
+            switch (Text->Align & AH_MASK)
+            {
+            case AH_RIGHT:
+                XShift = Client->r - Line->Width - Client->l + 1;
+                break;
+            case AH_CENTER:
+                XShift = (Client->r - Client->l - Line->Width + 1) / 2;
+                break;
+            case AH_LEFT:
+            default:
+                XShift = 0;
+                break;
+            }
+            XShift += TextDX;
 
+            LineRect = Rect(Client->l + XShift, LineTop,
+                            Client->l + XShift + Line->Width - 1, LineTop + Text->Font->FontHeight - 1);
+            tmpRect = LineRect;
+            if (!GDI_ANDRectangles(&tmpRect, &tmpClient)) continue;
 
+            GDI_SUBRectFromRegion(BorderRgn, &tmpRect);
 
+            PixX = tmpRect.l - LineRect.l;                                                          // Pixel X shift in the line
+            PixY = tmpRect.t - LineRect.t;                                                          // Pixel Y shift in the line
+            dx   = tmpRect.r - tmpRect.l + 1;                                                       // X pixels to draw
+            dy   = tmpRect.b - tmpRect.t + 1;                                                       // Y pixels to draw
+            Pos  = tmpRect.lt;
 
+            /* Glyphs on the left of the clip are skipped at once */
+            Index = GDI_GetLineSymbolByXShift(Text, Line, &PixX);
+            GDI_DrawGlyphRun565(&gd, &Text->Text[Index], Line->Start + Line->Length - Index, PixX, &Pos, PixY, &dx, dy);
+            if (Line->Ellipsis)
+            {
+                if (Index < Line->Start + Line->Length) PixX = 0;
+                GDI_DrawGlyphRun565(&gd, Text->EllipsisText, Text->EllipsisLength, PixX, &Pos, PixY, &dx, dy);
+            }
+            if (dx)                                                                                 // Not drawn symbols
+            {
+                TRECT Rest = Rect(Pos.x, Pos.y, tmpRect.r, tmpRect.b);
 
+                GDI_ADDRectToRegion(BorderRgn, &Rest);
+            }
         }
     }
-    return BorderRects;
-}
-
-
-
-
-
-
 
+    if (!Transparent)
+    {
+        uint32_t Count;
+        pRECT    Rects = GDI_GetRegionRects(BorderRgn, &Count);
 
+        while(Count--) GDI_FillRectangleX(lc, Rects++, BackColor);
+    }
+    GDI_FreeRegion(&tmpBorderRgn);
 
+    return true;
+}
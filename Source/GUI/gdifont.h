@@ -19,6 +19,84 @@
 #ifndef _GDIFONT_H_
 #define _GDIFONT_H_
 
+typedef enum tag_TEXTALIGN
+{
+    AH_LEFT     = (0 << 0),
+    AH_CENTER   = (1 << 0),
+    AH_RIGHT    = (2 << 0),
+    AH_MASK     = (3 << 0),
+    AV_TOP      = (0 << 2),
+    AV_CENTER   = (1 << 2),
+    AV_BOTTOM   = (2 << 2),
+    AV_MASK     = (3 << 2)
+} TTEXTALIGN;
 
+typedef enum tag_TEXTFLAGS
+{
+    TXF_WORDWRAP    = (1 << 0),                                                                     // Break the lines wider than MaxWidth
+    TXF_ELLIPSIS    = (1 << 1)                                                                      // Truncate the text that does not fit with an ellipsis
+} TTEXTFLAGS;
+
+typedef struct tag_TEXTLINE
+{
+    uint16_t Start;                                                                                 // Index of the first symbol
+    uint16_t Length;                                                                                // Number of symbols to draw
+    uint16_t Width;                                                                                 // Width in pixels with the ellipsis
+    boolean  Ellipsis;
+} TTEXTLINE, *pTEXTLINE;
+
+/*
+The layout (advances, lines and extent) is calculated once and kept until
+the string, the font or the width is changed by the GDI_SetText... functions.
+If the fields are changed directly, LayoutValid must be cleared.
+*/
+typedef struct tag_TEXT
+{
+    pBFC_FONT     Font;
+    wchar_t       *Text;
+    TSIZEXY       Extent;                                                                           // Size of the text in pixels
+    TTEXTALIGN    Align;
+    TTEXTFLAGS    Flags;
+    int16_t       MaxWidth;                                                                         // 0 - not limited
+    uint16_t      MaxLines;                                                                         // 0 - not limited
+    boolean       LayoutValid;
+    uint32_t      Length;                                                                           // Number of symbols in Advances
+    uint32_t      AdvancesSize;
+    uint16_t      *Advances;                                                                        // End of every symbol in pixels
+    uint32_t      LineCount;
+    uint32_t      LinesSize;
+    pTEXTLINE     Lines;
+    const wchar_t *EllipsisText;
+    uint16_t      EllipsisLength;                                                                   // Number of symbols in EllipsisText
+    uint16_t      EllipsisWidth;
+} TTEXT, *pTEXT;
+
+typedef struct tag_GLYPHCACHESTAT
+{
+    uint32_t Hits;
+    uint32_t Misses;
+    uint32_t Evictions;
+    uint32_t Count;                                                                                 // Cached glyphs
+    uint32_t Used;                                                                                  // Bytes
+    uint32_t Limit;                                                                                 // Bytes
+} TGLYPHCACHESTAT, *pGLYPHCACHESTAT;
+
+extern void GDI_FlushGlyphCache(pBFC_FONT Font);
+extern void GDI_SetGlyphCacheLimit(uint32_t Limit);
+extern void GDI_GetGlyphCacheStat(pGLYPHCACHESTAT Stat);
+extern boolean GDI_LoadFont(pBFC_FONT Font);
+extern void GDI_UnloadFont(pBFC_FONT Font);
+extern TSIZEXY GDI_GetTextExtent(pBFC_FONT Font, wchar_t *Text);
+extern pTEXT GDI_CreateText(pBFC_FONT Font, wchar_t *String, TTEXTALIGN Align,
+                            TTEXTFLAGS Flags, int16_t MaxWidth, uint16_t MaxLines);
+extern void GDI_DestroyText(pTEXT Text);
+extern boolean GDI_SetTextString(pTEXT Text, wchar_t *String);
+extern void GDI_SetTextFont(pTEXT Text, pBFC_FONT Font);
+extern void GDI_SetTextWidth(pTEXT Text, int16_t MaxWidth);
+extern boolean GDI_UpdateTextLayout(pTEXT Text);
+extern void GDI_FreeTextLayout(pTEXT Text);
+extern boolean GDI_DrawText565(TVLINDEX Layer, pTEXT Text, pRECT Client, pRECT Clip,
+                               uint32_t ForeColor, uint32_t BackColor, int16_t TextDX, int16_t TextDY,
+                               pREGION BorderRgn);
 
 #endif /* _GDIFONT_H_ */
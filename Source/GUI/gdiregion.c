@@ -0,0 +1,436 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "gdiregion.h"
+
+#define RGN_MINSIZE     8                                                                           // Initial number of rectangles to allocate
+#define RGN_RECTS(r)    (((r)->Count > 1) ? (r)->Rects : &(r)->Extent)
+
+typedef enum tag_RGNOP
+{
+    RO_AND,
+    RO_ADD,
+    RO_SUB
+} TRGNOP;
+
+static boolean GDI_IsRectValid(pRECT Rct)
+{
+    return ((Rct != NULL) && (Rct->l <= Rct->r) && (Rct->t <= Rct->b)) ? true : false;
+}
+
+/* Appends a rectangle to the region being built. The first rectangle is kept in Extent. */
+static boolean GDI_AppendRect(pREGION Rgn, int32_t l, int32_t t, int32_t r, int32_t b)
+{
+    if (Rgn->Count == 0)
+    {
+        Rgn->Extent = Rect(l, t, r, b);
+        Rgn->Count = 1;
+        return true;
+    }
+    if (Rgn->Count >= Rgn->Size)
+    {
+        uint32_t NewSize = (Rgn->Size < RGN_MINSIZE) ? RGN_MINSIZE : 2 * Rgn->Size;
+        pRECT    NewRects = realloc(Rgn->Rects, NewSize * sizeof(TRECT));
+
+        if (NewRects == NULL) return false;
+        Rgn->Rects = NewRects;
+        Rgn->Size = NewSize;
+    }
+    if (Rgn->Count == 1) Rgn->Rects[0] = Rgn->Extent;
+    Rgn->Rects[Rgn->Count++] = Rect(l, t, r, b);
+
+    return true;
+}
+
+/* Merges the last band with the previous one if they are adjacent and have the same spans. */
+static uint32_t GDI_CoalesceBands(pREGION Rgn, uint32_t PrevBand, uint32_t CurBand)
+{
+    pRECT    Rects = RGN_RECTS(Rgn);
+    uint32_t i, n = CurBand - PrevBand;
+
+    if ((PrevBand == CurBand) || (Rgn->Count - CurBand != n) ||
+            (Rects[PrevBand].b + 1 != Rects[CurBand].t)) return CurBand;
+
+    for(i = 0; i < n; i++)
+    {
+        if ((Rects[PrevBand + i].l != Rects[CurBand + i].l) ||
+                (Rects[PrevBand + i].r != Rects[CurBand + i].r)) return CurBand;
+    }
+    for(i = 0; i < n; i++) Rects[PrevBand + i].b = Rects[CurBand].b;
+    Rgn->Count = CurBand;
+    if (Rgn->Count == 1) Rgn->Extent = Rects[0];
+
+    return PrevBand;
+}
+
+static boolean GDI_MergeSpans(pREGION Rgn, TRGNOP Op, int32_t t, int32_t b,
+                              pRECT a, pRECT aEnd, pRECT s, pRECT sEnd)
+{
+    switch(Op)
+    {
+    case RO_AND:
+        while((a < aEnd) && (s < sEnd))
+        {
+            int32_t l = max(a->l, s->l);
+            int32_t r = min(a->r, s->r);
+
+            if ((l <= r) && !GDI_AppendRect(Rgn, l, t, r, b)) return false;
+            if (a->r < s->r) a++;
+            else s++;
+        }
+        break;
+    case RO_ADD:
+    {
+        int32_t l, r;
+        pRECT   Next;
+
+        if ((a >= aEnd) && (s >= sEnd)) break;
+        Next = ((s >= sEnd) || ((a < aEnd) && (a->l <= s->l))) ? a++ : s++;
+        l = Next->l;
+        r = Next->r;
+        while((a < aEnd) || (s < sEnd))
+        {
+            Next = ((s >= sEnd) || ((a < aEnd) && (a->l <= s->l))) ? a++ : s++;
+            if (Next->l <= r + 1) r = max(r, Next->r);
+            else
+            {
+                if (!GDI_AppendRect(Rgn, l, t, r, b)) return false;
+                l = Next->l;
+                r = Next->r;
+            }
+        }
+        if (!GDI_AppendRect(Rgn, l, t, r, b)) return false;
+    }
+    break;
+    case RO_SUB:
+        for(; a < aEnd; a++)
+        {
+            int32_t l = a->l;
+
+            while((s < sEnd) && (s->r < l)) s++;
+            while((s < sEnd) && (s->l <= a->r))
+            {
+                if ((s->l > l) && !GDI_AppendRect(Rgn, l, t, s->l - 1, b)) return false;
+                l = s->r + 1;
+                if (s->r > a->r) break;                                                             // This span may also cover the next one
+                s++;
+            }
+            if ((l <= a->r) && !GDI_AppendRect(Rgn, l, t, a->r, b)) return false;
+        }
+        break;
+    }
+    return true;
+}
+
+static void GDI_UpdateExtent(pREGION Rgn)
+{
+    if (Rgn->Count > 1)
+    {
+        pRECT    Rects = Rgn->Rects;
+        uint32_t i;
+
+        Rgn->Extent = Rects[0];
+        Rgn->Extent.b = Rects[Rgn->Count - 1].b;
+        for(i = 1; i < Rgn->Count; i++)
+        {
+            if (Rects[i].l < Rgn->Extent.l) Rgn->Extent.l = Rects[i].l;
+            if (Rects[i].r > Rgn->Extent.r) Rgn->Extent.r = Rects[i].r;
+        }
+    }
+    else if (Rgn->Count == 0) Rgn->Extent = Rect(0, 0, 0, 0);
+}
+
+/*
+Walks both regions band by band. Each step takes the largest row range where
+neither region changes its spans and combines the spans of that range.
+On out of memory the result degrades to a covering rectangle, so that
+the caller never loses pixels to be painted.
+*/
+static boolean GDI_RegionOp(pREGION Dst, pREGION a, pREGION b, TRGNOP Op)
+{
+    TREGION  Res = {0};
+    pRECT    ra, rb, aEnd, bEnd;
+    int32_t  y = INT16_MIN;
+    uint32_t PrevBand = 0;
+    boolean  Fail = false;
+
+    ra = RGN_RECTS(a);
+    aEnd = ra + a->Count;
+    rb = RGN_RECTS(b);
+    bEnd = rb + b->Count;
+
+    if ((Dst != a) && (Dst != b))                                                                   // Reuse the storage of the destination
+    {
+        Res.Rects = Dst->Rects;
+        Res.Size = Dst->Size;
+        Dst->Rects = NULL;
+        Dst->Size = 0;
+    }
+
+    while((ra < aEnd) || (rb < bEnd))
+    {
+        pRECT   aBandEnd = ra, bBandEnd = rb;
+        boolean aIn, bIn;
+        int32_t yb;
+
+        if ((Op == RO_AND) && ((ra >= aEnd) || (rb >= bEnd))) break;
+        if ((Op == RO_SUB) && (ra >= aEnd)) break;
+
+        yb = (ra < aEnd) ? ra->t : INT16_MAX;                                                       // Skip the rows outside of both regions
+        if ((rb < bEnd) && (rb->t < yb)) yb = rb->t;
+        if (y < yb) y = yb;
+
+        aIn = (ra < aEnd) && (y >= ra->t);
+        bIn = (rb < bEnd) && (y >= rb->t);
+
+        yb = INT16_MAX;
+        if (ra < aEnd) yb = min(yb, aIn ? ra->b : ra->t - 1);
+        if (rb < bEnd) yb = min(yb, bIn ? rb->b : rb->t - 1);
+
+        if (aIn) while((aBandEnd < aEnd) && (aBandEnd->t == ra->t)) aBandEnd++;
+        if (bIn) while((bBandEnd < bEnd) && (bBandEnd->t == rb->t)) bBandEnd++;
+
+        if (aIn || bIn)
+        {
+            uint32_t CurBand = Res.Count;
+
+            if (!GDI_MergeSpans(&Res, Op, y, yb, ra, aIn ? aBandEnd : ra, rb, bIn ? bBandEnd : rb))
+            {
+                Fail = true;
+                break;
+            }
+            if (Res.Count != CurBand) PrevBand = GDI_CoalesceBands(&Res, PrevBand, CurBand);
+        }
+
+        if (aIn && (ra->b == yb)) ra = aBandEnd;
+        if (bIn && (rb->b == yb)) rb = bBandEnd;
+        y = yb + 1;
+    }
+
+    if (Fail)
+    {
+        TRECT Cover = a->Extent;
+
+        Res.Count = 1;
+        switch(Op)
+        {
+        case RO_AND:
+            if (!GDI_ANDRectangles(&Cover, &b->Extent)) Res.Count = 0;
+            break;
+        case RO_ADD:
+            if (a->Count == 0) Cover = b->Extent;
+            else if (b->Count != 0)
+            {
+                Cover.l = min(Cover.l, b->Extent.l);
+                Cover.t = min(Cover.t, b->Extent.t);
+                Cover.r = max(Cover.r, b->Extent.r);
+                Cover.b = max(Cover.b, b->Extent.b);
+            }
+            Res.Count = ((a->Count != 0) || (b->Count != 0)) ? 1 : 0;
+            break;
+        case RO_SUB:
+            Res.Count = (a->Count != 0) ? 1 : 0;
+            break;
+        }
+        Res.Extent = Cover;
+    }
+    else GDI_UpdateExtent(&Res);
+
+    GDI_FreeRegion(Dst);
+    *Dst = Res;
+
+    return Dst->Count != 0;
+}
+
+void GDI_InitRegion(pREGION Rgn)
+{
+    if (Rgn != NULL) memset(Rgn, 0x00, sizeof(TREGION));
+}
+
+void GDI_FreeRegion(pREGION Rgn)
+{
+    if (Rgn != NULL)
+    {
+        if (Rgn->Rects != NULL) free(Rgn->Rects);
+        memset(Rgn, 0x00, sizeof(TREGION));
+    }
+}
+
+boolean GDI_IsRegionEmpty(pREGION Rgn)
+{
+    return ((Rgn == NULL) || (Rgn->Count == 0)) ? true : false;
+}
+
+pRECT GDI_GetRegionRects(pREGION Rgn, uint32_t *Count)
+{
+    if (Count != NULL) *Count = (Rgn != NULL) ? Rgn->Count : 0;
+
+    return ((Rgn == NULL) || (Rgn->Count == 0)) ? NULL : RGN_RECTS(Rgn);
+}
+
+boolean GDI_SetRegionRect(pREGION Rgn, pRECT Rct)
+{
+    if (Rgn == NULL) return false;
+
+    Rgn->Count = GDI_IsRectValid(Rct) ? 1 : 0;
+    Rgn->Extent = (Rgn->Count) ? *Rct : Rect(0, 0, 0, 0);
+
+    return Rgn->Count != 0;
+}
+
+boolean GDI_CopyRegion(pREGION Dst, pREGION Src)
+{
+    if ((Dst == NULL) || (Src == NULL)) return false;
+    if (Dst == Src) return true;
+
+    if (Src->Count > 1)
+    {
+        if (Dst->Size < Src->Count)
+        {
+            pRECT NewRects = realloc(Dst->Rects, Src->Count * sizeof(TRECT));
+
+            if (NewRects == NULL) return false;
+            Dst->Rects = NewRects;
+            Dst->Size = Src->Count;
+        }
+        memcpy(Dst->Rects, Src->Rects, Src->Count * sizeof(TRECT));
+    }
+    Dst->Count = Src->Count;
+    Dst->Extent = Src->Extent;
+
+    return true;
+}
+
+// Dst = a & b
+boolean GDI_ANDRegions(pREGION Dst, pREGION a, pREGION b)
+{
+    if ((Dst == NULL) || (a == NULL) || (b == NULL)) return false;
+
+    if ((a->Count == 0) || (b->Count == 0) || !IsRectsOverlaps(&a->Extent, &b->Extent))
+    {
+        Dst->Count = 0;
+        Dst->Extent = Rect(0, 0, 0, 0);
+        return false;
+    }
+    if ((a->Count == 1) && (b->Count == 1))
+    {
+        TRECT tmpRect = a->Extent;
+
+        GDI_ANDRectangles(&tmpRect, &b->Extent);
+        return GDI_SetRegionRect(Dst, &tmpRect);
+    }
+    return GDI_RegionOp(Dst, a, b, RO_AND);
+}
+
+// Dst = a + b
+boolean GDI_ADDRegions(pREGION Dst, pREGION a, pREGION b)
+{
+    if ((Dst == NULL) || (a == NULL) || (b == NULL)) return false;
+
+    if (b->Count == 0) return GDI_CopyRegion(Dst, a) && (Dst->Count != 0);
+    if (a->Count == 0) return GDI_CopyRegion(Dst, b) && (Dst->Count != 0);
+
+    return GDI_RegionOp(Dst, a, b, RO_ADD);
+}
+
+// Dst = a - b
+boolean GDI_SUBRegions(pREGION Dst, pREGION a, pREGION b)
+{
+    if ((Dst == NULL) || (a == NULL) || (b == NULL)) return false;
+
+    if ((a->Count == 0) || (b->Count == 0) || !IsRectsOverlaps(&a->Extent, &b->Extent))
+        return GDI_CopyRegion(Dst, a) && (Dst->Count != 0);
+
+    return GDI_RegionOp(Dst, a, b, RO_SUB);
+}
+
+// Region = Region & Rct
+boolean GDI_ANDRegionWithRect(pREGION Region, pRECT Rct)
+{
+    TREGION tmpRgn = {0};
+
+    if (Region == NULL) return false;
+    if (!GDI_SetRegionRect(&tmpRgn, Rct)) return GDI_SetRegionRect(Region, NULL);
+
+    if (Region->Count == 1) return GDI_ANDRegions(Region, Region, &tmpRgn);
+    if ((Region->Count == 0) ||
+            ((Rct->l <= Region->Extent.l) && (Rct->r >= Region->Extent.r) &&
+             (Rct->t <= Region->Extent.t) && (Rct->b >= Region->Extent.b)))
+        return Region->Count != 0;
+
+    return GDI_ANDRegions(Region, Region, &tmpRgn);
+}
+
+// Region = Region + Rct
+boolean GDI_ADDRectToRegion(pREGION Region, pRECT Rct)
+{
+    TREGION tmpRgn = {0};
+
+    if (Region == NULL) return false;
+    if (!GDI_SetRegionRect(&tmpRgn, Rct)) return Region->Count != 0;
+
+    if ((Region->Count == 0) ||
+            ((Rct->l <= Region->Extent.l) && (Rct->r >= Region->Extent.r) &&
+             (Rct->t <= Region->Extent.t) && (Rct->b >= Region->Extent.b)))
+        return GDI_SetRegionRect(Region, Rct);
+    if ((Region->Count == 1) &&
+            (Rct->l >= Region->Extent.l) && (Rct->r <= Region->Extent.r) &&
+            (Rct->t >= Region->Extent.t) && (Rct->b <= Region->Extent.b))
+        return true;
+
+    return GDI_RegionOp(Region, Region, &tmpRgn, RO_ADD);
+}
+
+// Region = Region - Rct
+boolean GDI_SUBRectFromRegion(pREGION Region, pRECT Rct)
+{
+    TREGION tmpRgn = {0};
+
+    if (Region == NULL) return false;
+    if (!GDI_SetRegionRect(&tmpRgn, Rct) || (Region->Count == 0) ||
+            !IsRectsOverlaps(&Region->Extent, Rct)) return Region->Count != 0;
+
+    return GDI_RegionOp(Region, Region, &tmpRgn, RO_SUB);
+}
+
+void GDI_TranslateRegion(pREGION Rgn, int16_t dx, int16_t dy)
+{
+    if ((Rgn != NULL) && Rgn->Count && (dx || dy))
+    {
+        pRECT    Rects = RGN_RECTS(Rgn);
+        uint32_t i;
+
+        for(i = 0; i < Rgn->Count; i++)
+        {
+            Rects[i].l += dx;
+            Rects[i].r += dx;
+            Rects[i].t += dy;
+            Rects[i].b += dy;
+        }
+        if (Rgn->Count > 1)
+        {
+            Rgn->Extent.l += dx;
+            Rgn->Extent.r += dx;
+            Rgn->Extent.t += dy;
+            Rgn->Extent.b += dy;
+        }
+    }
+}
@@ -0,0 +1,51 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GDIREGION_H_
+#define _GDIREGION_H_
+
+/*
+The region is a set of non-overlapping rectangles stored in y-x bands.
+Rectangles of one band have the same top and bottom and are sorted by x,
+bands are sorted by y. Vertically adjacent bands with the same spans are merged,
+so the set of rectangles is always minimal for the given shape.
+A region of a single rectangle is stored in Extent and does not use the heap.
+*/
+typedef struct tag_REGION
+{
+    TRECT    Extent;                                                                                // Bounding rectangle
+    uint32_t Count;                                                                                 // Number of rectangles
+    uint32_t Size;                                                                                  // Allocated rectangles
+    pRECT    Rects;
+} TREGION, *pREGION;
+
+extern void GDI_InitRegion(pREGION Rgn);
+extern void GDI_FreeRegion(pREGION Rgn);
+extern boolean GDI_IsRegionEmpty(pREGION Rgn);
+extern pRECT GDI_GetRegionRects(pREGION Rgn, uint32_t *Count);
+extern boolean GDI_SetRegionRect(pREGION Rgn, pRECT Rct);
+extern boolean GDI_CopyRegion(pREGION Dst, pREGION Src);
+extern boolean GDI_ANDRegions(pREGION Dst, pREGION a, pREGION b);
+extern boolean GDI_ADDRegions(pREGION Dst, pREGION a, pREGION b);
+extern boolean GDI_SUBRegions(pREGION Dst, pREGION a, pREGION b);
+extern boolean GDI_ANDRegionWithRect(pREGION Region, pRECT Rct);
+extern boolean GDI_ADDRectToRegion(pREGION Region, pRECT Rct);
+extern boolean GDI_SUBRectFromRegion(pREGION Region, pRECT Rct);
+extern void GDI_TranslateRegion(pREGION Rgn, int16_t dx, int16_t dy);
+
+#endif /* _GDIREGION_H_ */
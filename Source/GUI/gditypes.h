@@ -87,4 +87,13 @@ typedef struct
     int16_t sy;
 } TSIZEXY, *pSIZEXY;
 
+typedef struct tag_BITMAP
+{
+    TCFORMAT ColorFormat;
+    uint16_t Width;
+    uint16_t Height;
+    uint32_t Stride;                                                                                // Bytes per row, 0 - Width * BPP
+    void     *Data;
+} TBITMAP, *pBITMAP;
+
 #endif /* _GDITYPES_H_ */
@@ -21,43 +21,6 @@
 #include "systemconfig.h"
 #include "gdiutils.h"
 
-static void GDI_MergeRectsInRegion(pDLIST Region)
-{
-    pDLITEM ModItem, CmpItem;
-    pRECT   ModRect, CmpRect;
-
-    if ((Region == NULL) || (DL_GetItemsCount(Region) <= 1)) return;
-
-    ModItem = DL_GetFirstItem(Region);
-    CmpItem = DL_GetNextItem(ModItem);
-
-    while((ModItem != NULL) && (CmpItem != NULL))
-    {
-        ModRect = (pRECT)ModItem->Data;
-        while ((ModRect != NULL) && (CmpItem != NULL))
-        {
-            CmpRect = (pRECT)CmpItem->Data;
-
-            if ((CmpRect != NULL) && (ModRect->t == CmpRect->t) && (ModRect->b == CmpRect->b) &&
-                    ((ModRect->l - CmpRect->r == 1) || (CmpRect->l - ModRect->r == 1)))
-            {
-                pDLITEM tmpItem = DL_GetNextItem(CmpItem);
-
-                ModRect->l = min(ModRect->l, CmpRect->l);
-                ModRect->r = max(ModRect->r, CmpRect->r);
-
-                free(CmpRect);
-                DL_DeleteItem(Region, CmpItem);
-                CmpItem = tmpItem;
-                continue;
-            }
-            CmpItem = DL_GetNextItem(CmpItem);
-        }
-        ModItem = DL_GetNextItem(ModItem);
-        CmpItem = DL_GetNextItem(ModItem);
-    }
-}
-
 TPOINT Point(int16_t x, int16_t y)
 {
     TPOINT Result = {x, y};
@@ -67,7 +30,7 @@ TPOINT Point(int16_t x, int16_t y)
 
 TRECT Rect(int16_t l, int16_t t, int16_t r, int16_t b)
 {
-    TRECT Result = {l, t, r, b};
+    TRECT Result = {.l = l, .t = t, .r = r, .b = b};
 
     return Result;
 }
@@ -165,13 +128,7 @@ TRECT GDI_LocalToGlobalRct(pRECT rct, pPOINT Offset)
             Res.r = Offset->x + rct->r;
             Res.b = Offset->y + rct->b;
         }
-        else
-        {
-            Res.l = rct->l;
-            Res.t = rct->t;
-            Res.r = rct->l;
-            Res.b = rct->t;
-        }
+        else Res = *rct;
     }
     return Res;
 }
@@ -189,13 +146,7 @@ TRECT GDI_GlobalToLocalRct(pRECT rct, pPOINT Offset)
             Res.r = rct->r - Offset->x;
             Res.b = rct->b - Offset->y;
         }
-        else
-        {
-            Res.l = rct->l;
-            Res.t = rct->t;
-            Res.r = rct->l;
-            Res.b = rct->t;
-        }
+        else Res = *rct;
     }
     return Res;
 }
@@ -349,136 +300,60 @@ pDLIST GDI_SUBRectangles(pRECT a, pRECT b)
     return Rlist;
 }
 
-boolean GDI_ADDRectToRegion(pDLIST Region, pRECT Rct)
+/* The frame buffer starts at the left top corner of LayerRgn, it moves together with the layer. */
+uint8_t *GDI_GetPixelPtr(pLCONTEXT lc, TPOINT pt)
 {
-    pRECT tmpRect;
-
-    if ((Region == NULL) || (Rct == NULL)) return false;
-
-    if (DL_GetItemsCount(Region))
-    {
-        pDLITEM tmpItem = DL_GetFirstItem(Region);
-
-        while(tmpItem != NULL)
-        {
-            tmpRect = (pRECT)tmpItem->Data;
-
-            if (IsRectsOverlaps(tmpRect, Rct))
-            {
-                pDLIST tmpList = GDI_SUBRectangles(tmpRect, Rct);
+    uint8_t *p = (uint8_t *)lc->FrameBuffer;
 
-                if (tmpList != NULL)
-                {
-                    pDLITEM tmpSUBItem;
-
-                    if (DL_GetItemsCount(tmpList))
-                    {
-                        tmpSUBItem = DL_GetFirstItem(tmpList);
-
-                        *tmpRect = *(pRECT)tmpSUBItem->Data;
-                        free(tmpSUBItem->Data);
-                        DL_DeleteFirstItem(tmpList);
-
-                        while((tmpSUBItem = DL_GetFirstItem(tmpList)) != NULL)
-                        {
-                            DL_InsertItemBefore(Region, tmpItem, tmpSUBItem->Data);
-                            DL_DeleteFirstItem(tmpList);
-                        }
-                    }
-                    else
-                    {
-                        tmpSUBItem = DL_GetNextItem(tmpItem);
-
-                        free(tmpItem->Data);
-                        DL_DeleteItem(Region, tmpItem);
-
-                        tmpItem = tmpSUBItem;
-                        free(tmpList);
-                        continue;
-                    }
-                    free(tmpList);
-                }
-            }
-            tmpItem = DL_GetNextItem(tmpItem);
-        }
-    }
-    tmpRect = malloc(sizeof(TRECT));
-    if (tmpRect != NULL)
-    {
-        *tmpRect = *Rct;
-        if (DL_AddItem(Region, tmpRect) == NULL) free(tmpRect);
-        else return true;
-    }
-    return false;
+    return &p[((pt.y - lc->LayerRgn.t) * (lc->LayerRgn.r - lc->LayerRgn.l + 1) +
+               pt.x - lc->LayerRgn.l) * lc->BPP];
 }
 
-boolean GDI_SUBRectFromRegion(pDLIST Region, pRECT Rct)
+/* Word aligned fill, the ARMv5TE version stores 8 registers at once. */
+static void GDI_FillWords(uint32_t *p, uint32_t Value, uint32_t Count)
 {
-    if (Region == NULL) return false;
-
-    if (DL_GetItemsCount(Region) && (Rct != NULL))
+#if defined(__ARM_ARCH_5TE__)
+    FillWords(p, Value, Count);
+#else
+    while(Count >= 4)
     {
-        pDLITEM tmpItem = DL_GetFirstItem(Region);
-
-        while(tmpItem != NULL)
-        {
-            pRECT tmpRect = (pRECT)tmpItem->Data;
-
-            if (IsRectsOverlaps(tmpRect, Rct))
-            {
-                pDLIST tmpList = GDI_SUBRectangles(tmpRect, Rct);
-
-                if (tmpList != NULL)
-                {
-                    pDLITEM tmpSUBItem;
-
-                    if (DL_GetItemsCount(tmpList))
-                    {
-                        tmpSUBItem = DL_GetFirstItem(tmpList);
-
-                        *tmpRect = *(pRECT)tmpSUBItem->Data;
-                        free(tmpSUBItem->Data);
-                        DL_DeleteFirstItem(tmpList);
-
-                        while((tmpSUBItem = DL_GetFirstItem(tmpList)) != NULL)
-                        {
-                            DL_InsertItemBefore(Region, tmpItem, tmpSUBItem->Data);
-                            DL_DeleteFirstItem(tmpList);
-                        }
-                    }
-                    else
-                    {
-                        tmpSUBItem = DL_GetNextItem(tmpItem);
-
-                        free(tmpItem->Data);
-                        DL_DeleteItem(Region, tmpItem);
-
-                        tmpItem = tmpSUBItem;
-                        free(tmpList);
-                        continue;
-                    }
-                    free(tmpList);
-                }
-            }
-            tmpItem = DL_GetNextItem(tmpItem);
-        }
-        GDI_MergeRectsInRegion(Region);
+        p[0] = Value;
+        p[1] = Value;
+        p[2] = Value;
+        p[3] = Value;
+        p += 4;
+        Count -= 4;
     }
-    return DL_GetItemsCount(Region) != 0;
+    while(Count--) *p++ = Value;
+#endif
 }
 
-uint8_t *GDI_GetPixelPtr(pLCONTEXT lc, TPOINT pt)
+static void GDI_FillSpan16(uint16_t *p, uint32_t Value, uint32_t Count)
 {
-    uint8_t *p = (uint8_t *)lc->FrameBuffer;
-
-    return &p[(pt.y * (lc->LayerRgn.r - lc->LayerRgn.l + 1) + pt.x) * lc->BPP];
+    if (((uintptr_t)p & 0x02) && Count)                                                             // Align to the word boundary
+    {
+        *p++ = Value;
+        Count--;
+    }
+    GDI_FillWords((uint32_t *)p, Value, Count >> 1);                                                // Two pixels per word
+    if (Count & 0x01) p[Count - 1] = Value;
 }
 
 void GDI_FillRectangleX(pLCONTEXT lc, pRECT Rct, uint32_t Color)
 {
-    int32_t  x, y, dpx;
+    uint32_t Width, Height, Stride;
+
+    if ((lc == NULL) || (Rct == NULL) || (lc->FrameBuffer == NULL) ||
+            (Rct->l > Rct->r) || (Rct->t > Rct->b)) return;
 
-    if ((lc == NULL) || (Rct == NULL) || (lc->FrameBuffer == NULL)) return;
+    Width  = Rct->r - Rct->l + 1;
+    Height = Rct->b - Rct->t + 1;
+    Stride = lc->LayerRgn.r - lc->LayerRgn.l + 1;
+    if (Width == Stride)                                                                            // Rows are contiguous, fill as a single span
+    {
+        Width *= Height;
+        Height = 1;
+    }
 
     switch (lc->ColorFormat)
     {
@@ -487,11 +362,11 @@ void GDI_FillRectangleX(pLCONTEXT lc, pRECT Rct, uint32_t Color)
         uint16_t *p = (uint16_t *)GDI_GetPixelPtr(lc, Rct->lt);
 
         Color = RGB_565(Color);
-        dpx = (lc->LayerRgn.r + 1) - (Rct->r - Rct->l + 1);
-        for(y = Rct->t; y <= Rct->b; y++)
+        Color |= Color << 16;
+        while(Height--)
         {
-            for(x = Rct->l; x <= Rct->r; x++) *p++ = Color;
-            p += dpx;
+            GDI_FillSpan16(p, Color, Width);
+            p += Stride;
         }
     }
     break;
@@ -501,11 +376,10 @@ void GDI_FillRectangleX(pLCONTEXT lc, pRECT Rct, uint32_t Color)
     {
         uint32_t *p = (uint32_t *)GDI_GetPixelPtr(lc, Rct->lt);
 
-        dpx = (lc->LayerRgn.r + 1) - (Rct->r + 1 - Rct->l);
-        for(y = Rct->t; y <= Rct->b; y++)
+        while(Height--)
         {
-            for(x = Rct->l; x <= Rct->r; x++) *p++ = Color;
-            p += dpx;
+            GDI_FillWords(p, Color, Width);
+            p += Stride;
         }
     }
     break;
@@ -514,3 +388,43 @@ void GDI_FillRectangleX(pLCONTEXT lc, pRECT Rct, uint32_t Color)
     }
     return;
 }
+
+#if _FILLBENCHMARK_
+/* Prints the rate of GDI_FillRectangleX for the frame buffer formats and rectangle sizes. */
+void GDI_BenchmarkFill(void)
+{
+    static const TCFORMAT Formats[] = {CF_RGB565, CF_ARGB8888};
+    static const int16_t  Rects[][4] =                                                              // l, t, r, b
+    {
+        {0, 0, 0, 0}, {0, 0, 3, 3}, {0, 0, 15, 15}, {1, 1, 64, 64},
+        {0, 0, 239, 0}, {0, 0, 0, 239}, {1, 0, 239, 239}, {0, 0, 239, 239}
+    };
+    TLCONTEXT lc = {0};
+    uint32_t  i, j;
+
+    lc.LayerRgn = Rect(0, 0, LCD_XRESOLUTION - 1, LCD_YRESOLUTION - 1);
+    lc.FrameBuffer = malloc(LCD_XRESOLUTION * LCD_YRESOLUTION * sizeof(uint32_t));
+    if (lc.FrameBuffer == NULL) return;
+
+    DebugPrint("Fill rate, MPix/s:\r\n");
+    for(i = 0; i < sizeof(Formats) / sizeof(Formats[0]); i++)
+    {
+        lc.ColorFormat = Formats[i];
+        lc.BPP = CFormatToBPP[Formats[i]];
+        for(j = 0; j < sizeof(Rects) / sizeof(Rects[0]); j++)
+        {
+            TRECT    Rct = Rect(Rects[j][0], Rects[j][1], Rects[j][2], Rects[j][3]);
+            uint32_t Size = (Rct.r - Rct.l + 1) * (Rct.b - Rct.t + 1);
+            uint32_t Count = (1 << 20) / Size + 1, Pixels = Count * Size;
+            int32_t  Ticks = USC_GetCurrentTicks();
+
+            while(Count--) GDI_FillRectangleX(&lc, &Rct, Count);
+            Ticks = max(USC_GetCurrentTicks() - Ticks, 1);
+
+            DebugPrint("CF %u, %ux%u at (%d,%d): %u.%02u\r\n", Formats[i], Rct.r - Rct.l + 1,
+                       Rct.b - Rct.t + 1, Rct.l, Rct.t, Pixels / Ticks, Pixels % Ticks * 100 / Ticks);
+        }
+    }
+    free(lc.FrameBuffer);
+}
+#endif /* _FILLBENCHMARK_ */
@@ -19,12 +19,25 @@
 #ifndef _GDIUTILS_H_
 #define _GDIUTILS_H_
 
-#define RGB_565(v)    ((((v) & 0xF80000) >> 8) | (((v) & 0xFC00) >> 5) | ((v) & 0x1F))
+#define RGB_565(v)    ((((v) & 0xF80000) >> 8) | (((v) & 0xFC00) >> 5) | (((v) & 0xF8) >> 3))
+#define RGB_8888(v)   (0xFF000000 | (((v) & 0xF800) << 8) | (((v) & 0xE000) << 3) |                \
+                       (((v) & 0x07E0) << 5) | (((v) & 0x0600) >> 1) |                             \
+                       (((v) & 0x001F) << 3) | (((v) & 0x001C) >> 2))
+
+/*
+RGB565 pixels are blended in the 0x07E0F81F form: the green field is moved
+to the upper half-word, so all three fields are multiplied by a 5-bit alpha
+at once without overflowing into each other.
+*/
+#define RGB565_EXPAND(c)    ((((uint32_t)(c)) | ((uint32_t)(c) << 16)) & 0x07E0F81F)
+#define RGB565_PACK(c)      ((uint16_t)((c) | ((c) >> 16)))
+#define RGB565_HALF         0x02008010                                                              // Rounds the >> 5 of the blend in every field
 
 extern TPOINT Point(int16_t x, int16_t y);
 extern TRECT Rect(int16_t l, int16_t t, int16_t r, int16_t b);
 extern boolean IsRectsOverlaps(pRECT a, pRECT b);
 extern boolean IsPointInRect(int16_t x, int16_t y, pRECT Rct);
+extern boolean IsRectInRect(pRECT a, pRECT b);
 extern TPOINT GDI_LocalToGlobalPt(pPOINT pt, pPOINT Offset);
 extern TPOINT GDI_GlobalToLocalPt(pPOINT pt, pPOINT Offset);
 extern TRECT GDI_LocalToGlobalRct(pRECT rct, pPOINT Offset);
@@ -32,8 +45,10 @@ extern TRECT GDI_GlobalToLocalRct(pRECT rct, pPOINT Offset);
 extern boolean GDI_ANDRectangles(pRECT a, pRECT b);
 extern pDLIST GDI_ADDRectangles(pRECT a, pRECT b);
 extern pDLIST GDI_SUBRectangles(pRECT a, pRECT b);
-extern boolean GDI_ADDRectToRegion(pDLIST Region, pRECT Rct);
-extern boolean GDI_SUBRectFromRegion(pDLIST Region, pRECT Rct);
+extern uint8_t *GDI_GetPixelPtr(pLCONTEXT lc, TPOINT pt);
 extern void GDI_FillRectangleX(pLCONTEXT lc, pRECT Rct, uint32_t Color);
+#if _FILLBENCHMARK_
+extern void GDI_BenchmarkFill(void);
+#endif /* _FILLBENCHMARK_ */
 
 #endif /* _GDIUTILS_H_ */
@@ -23,6 +23,33 @@
 
 pDLIST GUIWinZOrder[LCDIF_NUMLAYERS];
 
+/*
+Invalidated areas are not painted at once, they are merged into the dirty region
+of the layer and painted by GUI_ProcessPaint() in a single pass per main loop cycle.
+*/
+static TREGION    GUIDirtyRgn[LCDIF_NUMLAYERS];                                                     // In the layer coordinates
+static TREGION    GUIHiddenRgn[LCDIF_NUMLAYERS];                                                    // Dirty parts hidden by the opaque layers above
+static TREGION    GUIPaintedRgn;                                                                    // In the screen coordinates
+static boolean    GUICoverageChanged;                                                               // The hidden regions may be revealed
+static boolean    GUIPaintPass;
+static TPAINTSTAT GUIPaintStat;
+
+/*
+The pixels of the moved objects are copied by the next paint pass as well, before
+the dirty regions are painted, so nothing changes the frame buffer between the passes.
+The moves are copied in their order, the successive moves of one object are merged
+into a single copy from the pixels of the last pass.
+*/
+typedef struct tag_PIXMOVE
+{
+    pGUIHEADER Object;
+    TVLINDEX   Layer;
+    TREGION    Region;                                                                              // Destination in the layer coordinates
+    TPOINT     dXY;
+} TPIXMOVE, *pPIXMOVE;
+
+static TDLIST     GUIPixMoves;
+
 static boolean GUI_IsObjectVisibleAcrossParents(pPAINTEV PEvent)
 {
     boolean    IsStillVisible = false;
@@ -59,7 +86,7 @@ static boolean GUI_IsObjectVisibleAcrossParents(pPAINTEV PEvent)
     return IsStillVisible;
 }
 
-static boolean GUI_SubTopChildObjectsFromRegion(pDLIST Region, pGUIHEADER Object)
+static boolean GUI_SubTopChildObjectsFromRegion(pREGION Region, pGUIHEADER Object)
 {
     if (Object->Parent != NULL)
     {
@@ -67,7 +94,7 @@ static boolean GUI_SubTopChildObjectsFromRegion(pDLIST Region, pGUIHEADER Object
         pDLITEM tmpDLItem = DL_GetLastItem(ChildList);
 
         /* Subtract the positions of topmost child objects from the update region. */
-        while((tmpDLItem != NULL) && DL_GetItemsCount(Region))
+        while((tmpDLItem != NULL) && !GDI_IsRegionEmpty(Region))
         {
             pGUIHEADER tmpObject = (pGUIHEADER)tmpDLItem->Data;
 
@@ -80,27 +107,27 @@ static boolean GUI_SubTopChildObjectsFromRegion(pDLIST Region, pGUIHEADER Object
             tmpDLItem = DL_GetPrevItem(tmpDLItem);
         }
     }
-    return DL_GetItemsCount(Region) != 0;
+    return !GDI_IsRegionEmpty(Region);
 }
 
-static void GUI_UpdateObjectByRegion(pDLIST Region, pGUIHEADER Object, pRECT Clip)
+static void GUI_UpdateObjectByRegion(pREGION Region, pGUIHEADER Object, pRECT Clip)
 {
-    pDLITEM tmpItem = DL_GetFirstItem(Region);
+    uint32_t Count;
+    pRECT    Rects = GDI_GetRegionRects(Region, &Count);
 
-    while(tmpItem != NULL)
+    if ((Rects == NULL) || !IsRectsOverlaps(&Region->Extent, Clip)) return;
+
+    while(Count--)
     {
-        if (tmpItem->Data != NULL)
-        {
-            TRECT tmpRect = *(pRECT)tmpItem->Data;
+        TRECT tmpRect = *Rects++;
 
-            if (GDI_ANDRectangles(&tmpRect, Clip))
-                GUI_DrawObjectDefault(Object, &tmpRect);
-        }
-        tmpItem = DL_GetNextItem(tmpItem);
+        if (tmpRect.t > Clip->b) break;                                                             // Bands are sorted by y
+        if (GDI_ANDRectangles(&tmpRect, Clip))
+            GUI_DrawObjectDefault(Object, &tmpRect);
     }
 }
 
-static boolean GUI_UpdateChildTree(pDLIST Region, pWIN Win, pRECT Clip)
+static boolean GUI_UpdateChildTree(pREGION Region, pWIN Win, pRECT Clip)
 {
     pDLITEM    tmpItem = DL_GetLastItem(&Win->ChildObjects);
     pGUIHEADER tmpObject;
@@ -110,7 +137,8 @@ static boolean GUI_UpdateChildTree(pDLIST Region, pWIN Win, pRECT Clip)
     {
         TRECT tmpObjectRect = tmpObject->Position;
 
-        if ((tmpObject->Visible) && GDI_ANDRectangles(&tmpObjectRect, &tmpWinRect))
+        if ((tmpObject->Visible) && GDI_ANDRectangles(&tmpObjectRect, &tmpWinRect) &&
+                IsRectsOverlaps(&tmpObjectRect, &Region->Extent))
         {
             if (IsWindowObject(tmpObject))
             {
@@ -119,12 +147,171 @@ static boolean GUI_UpdateChildTree(pDLIST Region, pWIN Win, pRECT Clip)
             else GUI_UpdateObjectByRegion(Region, tmpObject, &tmpObjectRect);
             GDI_SUBRectFromRegion(Region, &tmpObjectRect);
         }
-        if (!DL_GetItemsCount(Region)) break;
+        if (GDI_IsRegionEmpty(Region)) break;
         tmpItem = DL_GetPrevItem(tmpItem);
     }
     GUI_UpdateObjectByRegion(Region, &Win->Head, Clip);
 
-    return DL_GetItemsCount(Region) != 0;
+    return !GDI_IsRegionEmpty(Region);
+}
+
+static uint32_t GUI_GetRegionArea(pREGION Region)
+{
+    uint32_t Count, Area = 0;
+    pRECT    Rects = GDI_GetRegionRects(Region, &Count);
+
+    while(Count--)
+    {
+        Area += (Rects->r - Rects->l + 1) * (Rects->b - Rects->t + 1);
+        Rects++;
+    }
+    return Area;
+}
+
+/* Takes the region over, returns false if the move is not recorded (out of memory). */
+static boolean GUI_AddPixelMove(pGUIHEADER Object, TVLINDEX Layer, pREGION Region, TPOINT dXY)
+{
+    pDLITEM  Last = DL_GetLastItem(&GUIPixMoves);
+    pPIXMOVE Move = (Last != NULL) ? (pPIXMOVE)Last->Data : NULL;
+
+    if ((Move == NULL) || (Move->Object != Object) || (Move->Layer != Layer))
+    {
+        Move = malloc(sizeof(TPIXMOVE));
+        if (Move == NULL) return false;
+        if (DL_AddItem(&GUIPixMoves, Move) == NULL)
+        {
+            free(Move);
+            return false;
+        }
+        Move->Object = Object;
+        Move->Layer = Layer;
+        Move->dXY = Point(0, 0);
+        GDI_InitRegion(&Move->Region);
+    }
+    GDI_FreeRegion(&Move->Region);                                                                  // The object pixels are in the new region now
+    Move->Region = *Region;
+    Move->dXY.x += dXY.x;
+    Move->dXY.y += dXY.y;
+    GDI_InitRegion(Region);
+
+    return true;
+}
+
+static void GUI_CopyPixelMoves(void)
+{
+    pDLITEM Item;
+
+    while((Item = DL_GetFirstItem(&GUIPixMoves)) != NULL)
+    {
+        pPIXMOVE Move = (pPIXMOVE)Item->Data;
+        uint32_t Count;
+        pRECT    Rects;
+
+        GDI_MoveRegion(Move->Layer, &Move->Region, Move->dXY);
+        GUIPaintStat.MovedPixels += GUI_GetRegionArea(&Move->Region);
+
+        Rects = GDI_GetRegionRects(&Move->Region, &Count);
+        while(Count--)
+        {
+            TRECT UpdateRect = GDI_LocalToGlobalRct(Rects++, &LCDScreen.VLayer[Move->Layer].LayerOffset);
+
+            UpdateRect = GDI_GlobalToLocalRct(&UpdateRect, &LCDScreen.ScreenOffset);
+            GUI_UpdateScreen(&UpdateRect);
+        }
+        GDI_FreeRegion(&Move->Region);
+        free(Move);
+        DL_DeleteFirstItem(&GUIPixMoves);
+    }
+}
+
+/* The part of the layer (in its coordinates) hidden by the opaque layers above it. */
+static boolean GUI_GetLayerCoverage(TVLINDEX Layer, pREGION Covered)
+{
+    uint32_t i;
+
+    for(i = Layer + 1; i < LCDIF_NUMLAYERS; i++)
+    {
+        if (LCDIF_IsLayerOpaque(i))
+        {
+            TRECT tmpRect = GDI_LocalToGlobalRct(&LCDScreen.VLayer[i].LayerRgn, &LCDScreen.VLayer[i].LayerOffset);
+
+            tmpRect = GDI_GlobalToLocalRct(&tmpRect, &LCDScreen.VLayer[Layer].LayerOffset);
+            GDI_ADDRectToRegion(Covered, &tmpRect);
+        }
+    }
+    return !GDI_IsRegionEmpty(Covered);
+}
+
+/* Removes the hidden part from the region, it is painted when the layer becomes visible. */
+static void GUI_CullHiddenRegion(TVLINDEX Layer, pREGION Region)
+{
+    TREGION Covered = {0}, Hidden = {0};
+
+    if (GUI_GetLayerCoverage(Layer, &Covered) && GDI_ANDRegions(&Hidden, Region, &Covered))
+    {
+        GUIPaintStat.CulledPixels += GUI_GetRegionArea(&Hidden);
+        GDI_ADDRegions(&GUIHiddenRgn[Layer], &GUIHiddenRgn[Layer], &Hidden);
+        GDI_SUBRegions(Region, Region, &Covered);
+    }
+    GDI_FreeRegion(&Hidden);
+    GDI_FreeRegion(&Covered);
+}
+
+/* Moves the hidden parts uncovered by the layers above back to the dirty region. */
+static void GUI_RevealHiddenRegion(TVLINDEX Layer)
+{
+    TREGION Covered = {0}, Revealed = {0};
+
+    if (GDI_IsRegionEmpty(&GUIHiddenRgn[Layer])) return;
+
+    GUI_GetLayerCoverage(Layer, &Covered);
+    if (GDI_SUBRegions(&Revealed, &GUIHiddenRgn[Layer], &Covered))
+    {
+        GDI_ADDRegions(&GUIDirtyRgn[Layer], &GUIDirtyRgn[Layer], &Revealed);
+        GDI_SUBRegions(&GUIHiddenRgn[Layer], &GUIHiddenRgn[Layer], &Revealed);
+    }
+    GDI_FreeRegion(&Revealed);
+    GDI_FreeRegion(&Covered);
+}
+
+/* Paints the windows of the layer from the top to the bottom, every pixel of the region is drawn once. */
+static void GUI_PaintLayerRegion(TVLINDEX Layer, pREGION Region)
+{
+    pDLITEM tmpItem = DL_GetLastItem(GUIWinZOrder[Layer]);
+
+    while((tmpItem != NULL) && !GDI_IsRegionEmpty(Region))
+    {
+        pWIN Win = (pWIN)tmpItem->Data;
+
+        if ((Win != NULL) && Win->Head.Visible && IsRectsOverlaps(&Win->Head.Position, &Region->Extent))
+        {
+            if (GUI_UpdateChildTree(Region, Win, &Win->Head.Position))
+                GDI_SUBRectFromRegion(Region, &Win->Head.Position);
+        }
+        tmpItem = DL_GetPrevItem(tmpItem);
+    }
+}
+
+/* The part of the object position clipped by the parents and not covered by the objects above it. */
+boolean GUI_GetObjectVisibleRegion(pGUIHEADER Object, pREGION Region, TVLINDEX *Layer)
+{
+    TPAINTEV   PaintEvent = {0};
+    pGUIHEADER tmpObject;
+
+    PaintEvent.Object = Object;
+    PaintEvent.UpdateRect = Object->Position;
+
+    if (!GUI_IsObjectVisibleAcrossParents(&PaintEvent)) return false;
+
+    *Layer = ((pWIN)PaintEvent.RootParent)->Layer;
+    if (!GDI_ANDRectangles(&PaintEvent.UpdateRect, &LCDScreen.VLayer[*Layer].LayerRgn) ||
+            !GDI_SetRegionRect(Region, &PaintEvent.UpdateRect) ||
+            !GUI_GridSubWindowsAbove(Region, (pWIN)PaintEvent.RootParent)) return false;
+
+    for(tmpObject = Object; tmpObject->Parent != NULL; tmpObject = tmpObject->Parent)
+        if (!GUI_SubTopChildObjectsFromRegion(Region, tmpObject)) return false;
+
+    return true;
 }
 
 boolean GUI_Initialize(void)
@@ -179,100 +366,278 @@ boolean GUI_Initialize(void)
 */
 void GUI_Invalidate(pGUIHEADER Object, pRECT Rct)
 {
-    TPAINTEV PaintEvent = {0};
+    if (IsWindowObject(Object)) GUI_DropBackStore((pWIN)Object);                                    // The content is changed
+
+    GUI_Expose(Object, Rct);
+}
 
+/* The same as GUI_Invalidate, but the content of the object is not changed, only uncovered. */
+void GUI_Expose(pGUIHEADER Object, pRECT Rct)
+{
     if (Object != NULL)
     {
+        TPAINTEV PaintEvent = {0};
+
         PaintEvent.Object = Object;
         PaintEvent.UpdateRect = (Rct != NULL) ? *Rct : Object->Position;
 
         if (GUI_IsObjectVisibleAcrossParents(&PaintEvent))
-            EM_PostEvent(ET_ONPAINT, NULL, &PaintEvent, sizeof(TPAINTEV));
+            GUI_InvalidateLayer(((pWIN)PaintEvent.RootParent)->Layer, &PaintEvent.UpdateRect);
     }
-    else
+    else                                                                                            // Screen coordinates, goes to every enabled layer
+    {
+        TRECT    ScreenRect = (Rct != NULL) ? *Rct : LCDScreen.ScreenRgn;
+        uint32_t i;
+
+        ScreenRect = GDI_LocalToGlobalRct(&ScreenRect, &LCDScreen.ScreenOffset);
+        for(i = 0; i < LCDIF_NUMLAYERS; i++)
+        {
+            pLCONTEXT lc = &LCDScreen.VLayer[i];
+            TRECT     LayerRect;
+
+            if (!lc->Initialized || !lc->Enabled) continue;
+
+            LayerRect = GDI_GlobalToLocalRct(&ScreenRect, &lc->LayerOffset);
+            GUI_InvalidateLayer(i, &LayerRect);
+        }
+    }
+}
+
+/* Rct coordinates relative to the layer. */
+void GUI_InvalidateLayer(TVLINDEX Layer, pRECT Rct)
+{
+    TRECT tmpRect;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || (Rct == NULL)) return;
+
+    tmpRect = *Rct;
+    if (GDI_ANDRectangles(&tmpRect, &LCDScreen.VLayer[Layer].LayerRgn))
+        GDI_ADDRectToRegion(&GUIDirtyRgn[Layer], &tmpRect);                                         // On out of memory the region grows to the covering rectangle
+}
+
+/* Called by the objects drawing code for the painted part of the layer. */
+void GUI_UpdateScreenRect(TVLINDEX Layer, pRECT Rct)
+{
+    TRECT UpdateRect;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || (Rct == NULL)) return;
+
+    UpdateRect = GDI_LocalToGlobalRct(Rct, &LCDScreen.VLayer[Layer].LayerOffset);
+    UpdateRect = GDI_GlobalToLocalRct(&UpdateRect, &LCDScreen.ScreenOffset);
+
+    GUIPaintStat.PaintedPixels += (Rct->r - Rct->l + 1) * (Rct->b - Rct->t + 1);
+
+    GUI_UpdateScreen(&UpdateRect);
+}
+
+/* Rct in the screen coordinates. The screen is updated once per frame by the merged region. */
+void GUI_UpdateScreen(pRECT Rct)
+{
+    TRECT UpdateRect;
+
+    if (Rct == NULL) return;
+
+    UpdateRect = *Rct;
+    if (GDI_ANDRectangles(&UpdateRect, &LCDScreen.ScreenRgn) &&
+            !GDI_ADDRectToRegion(&GUIPaintedRgn, &UpdateRect))
+        LCDIF_UpdateRectangle(UpdateRect);
+}
+
+static void GUI_EndPaintPass(void)
+{
+    uint32_t Count;
+    pRECT    Rects;
+
+    if (GUIPaintPass) GUIPaintStat.Passes++;
+    else if (GDI_IsRegionEmpty(&GUIPaintedRgn)) return;                                             // Nothing painted or moved
+
+    GUIPaintPass = false;
+
+    Rects = GDI_GetRegionRects(&GUIPaintedRgn, &Count);
+    for(; Count; Count--, Rects++)
+        if (LCDIF_SubmitUpdate(*Rects, NULL, NULL, NULL) == LQS_FULL) break;
+
+    if (Count)                                                                                      // The LCD queue is full, the rest is sent with the next frame
     {
-        PaintEvent.UpdateRect = (Rct != NULL) ? *Rct : LCDScreen.ScreenRgn;
+        TREGION Unsent;
 
-        EM_PostEvent(ET_ONPAINT, NULL, &PaintEvent, sizeof(TPAINTEV));
+        GDI_InitRegion(&Unsent);
+        while(Count--) GDI_ADDRectToRegion(&Unsent, Rects++);
+        GDI_CopyRegion(&GUIPaintedRgn, &Unsent);                                                    // On out of memory the whole region is sent again
+        GDI_FreeRegion(&Unsent);
     }
+    else GDI_FreeRegion(&GUIPaintedRgn);
 }
 
-void GUI_OnPaintHandler(pPAINTEV Event)
+void GUI_ProcessPaint(void)
 {
-    if (Event != NULL)
+    uint32_t i;
+    boolean  Reveal = GUICoverageChanged;
+
+    GUICoverageChanged = false;
+    LCDIF_CommitLayers();                                                                           // The layer settings and the moves of the last frame
+    GUI_CopyPixelMoves();
+    for(i = LCDIF_NUMLAYERS; i--;)                                                                  // From the top layer to the bottom one
     {
-        if (Event->RootParent != NULL)                                                              // Invalidate by object
-        {
-            if (IsWindowObject(Event->RootParent) &&
-                    GDI_ANDRectangles(&Event->UpdateRect,
-                                      &LCDScreen.VLayer[((pWIN)Event->RootParent)->Layer].LayerRgn))
-            {
-                pDLIST UpdateRgn = DL_Create(0);
-                pRECT  SeedRect = malloc(sizeof(TRECT));
+        if (Reveal) GUI_RevealHiddenRegion(i);
+        if (GDI_IsRegionEmpty(&GUIDirtyRgn[i])) continue;
+
+        GUIPaintStat.InvalidatedPixels += GUI_GetRegionArea(&GUIDirtyRgn[i]);
+        GUI_CullHiddenRegion(i, &GUIDirtyRgn[i]);
+        GUIPaintPass = true;
+        GUI_PaintLayerRegion(i, &GUIDirtyRgn[i]);
+        GDI_FreeRegion(&GUIDirtyRgn[i]);                                                            // The rest is not covered by windows
+    }
+    GUI_EndPaintPass();
+}
 
-                if ((UpdateRgn != NULL) && (SeedRect != NULL) &&
-                        (DL_AddItem(UpdateRgn, SeedRect) != NULL))
-                {
-                    pDLITEM    tmpDLItem;
-                    pGUIHEADER tmpObject;
-
-                    *SeedRect = Event->UpdateRect;
-
-                    /* Subtract the positions of topmost windows from the update region. */
-                    tmpDLItem = DL_GetLastItem(GUIWinZOrder[((pWIN)Event->RootParent)->Layer]);
-                    while((tmpDLItem != NULL) && DL_GetItemsCount(UpdateRgn))
-                    {
-                        tmpObject = (pGUIHEADER)tmpDLItem->Data;
-
-                        if ((uintptr_t)tmpObject == (uintptr_t)Event->RootParent) break;
-                        if ((tmpObject != NULL) && tmpObject->Visible &&
-                                !GDI_SUBRectFromRegion(UpdateRgn, &tmpObject->Position)) break;
-
-                        tmpDLItem = DL_GetPrevItem(tmpDLItem);
-                    }
-
-                    if (DL_GetItemsCount(UpdateRgn))
-                    {
-                        if (Event->Object->Parent != NULL)
-                        {
-                            tmpObject = Event->Object;
-                            /* Subtract the positions of the topmost child back through the parent tree. */
-                            while (tmpObject->Parent != NULL)
-                            {
-                                if (!GUI_SubTopChildObjectsFromRegion(UpdateRgn, tmpObject)) break;
-                                tmpObject = tmpObject->Parent;
-                            }
-                        }
-
-                        if (IsWindowObject(Event->Object) && DL_GetItemsCount(UpdateRgn))
-                        {
-                            /* Update the tree of child objects. */
-                            if (GUI_UpdateChildTree(UpdateRgn, (pWIN)Event->Object, &Event->Object->Position))
-                                GDI_SUBRectFromRegion(UpdateRgn, &Event->Object->Position);
-                        }
-
-                        /* Draw parts of the object */
-                        while((tmpDLItem = DL_GetFirstItem(UpdateRgn)) != NULL)
-                        {
-                            pRECT tmpObjectRect = (pRECT)tmpDLItem->Data;
-
-                            if (tmpObjectRect != NULL)
-                            {
-                                GUI_DrawObjectDefault(Event->Object, tmpObjectRect);
-                                free(tmpDLItem->Data);
-                            }
-                            DL_DeleteFirstItem(UpdateRgn);
-                        }
-                    }
-                }
-                else if (SeedRect != NULL) free(SeedRect);
+/*
+True if something waits to be painted or sent to the screen.
+The hidden regions are pending only until the layer coverage is changed.
+*/
+boolean GUI_IsPaintPending(void)
+{
+    uint32_t i;
 
-                DL_Delete(UpdateRgn, false);
-            }
-        }
-        else                                                                                        // Invalidate by screen
-        {
+    if (DL_GetItemsCount(&GUIPixMoves)) return true;
+    for(i = 0; i < LCDIF_NUMLAYERS; i++)
+        if (!GDI_IsRegionEmpty(&GUIDirtyRgn[i]) ||
+                (GUICoverageChanged && !GDI_IsRegionEmpty(&GUIHiddenRgn[i]))) return true;
+
+    return !GDI_IsRegionEmpty(&GUIPaintedRgn);
+}
 
+/*
+The part of the object which frame buffer pixels are up to date:
+visible and not waiting to be painted.
+*/
+boolean GUI_GetObjectValidRegion(pGUIHEADER Object, pREGION Region)
+{
+    TVLINDEX Layer;
+
+    if ((Object == NULL) || (Region == NULL) || !GUI_GetObjectVisibleRegion(Object, Region, &Layer)) return false;
+
+    GDI_SUBRegions(Region, Region, &GUIDirtyRgn[Layer]);
+    GDI_SUBRegions(Region, Region, &GUIHiddenRgn[Layer]);
+
+    return !GDI_IsRegionEmpty(Region);
+}
+
+/*
+Called after the object is moved by dXY. The valid pixels of its old position are copied
+to the visible part of the new one by the next paint pass, the rest of the object is invalidated.
+ValidRgn is taken over by the move.
+*/
+void GUI_MoveObjectPixels(pGUIHEADER Object, pREGION ValidRgn, TPOINT dXY)
+{
+    TREGION  VisibleRgn = {0};
+    TVLINDEX Layer;
+
+    if ((Object == NULL) || (ValidRgn == NULL)) return;
+
+    if (GUI_GetObjectVisibleRegion(Object, &VisibleRgn, &Layer))
+    {
+        GDI_TranslateRegion(ValidRgn, dXY.x, dXY.y);
+        if (GDI_ANDRegions(ValidRgn, ValidRgn, &VisibleRgn))
+        {
+            GDI_SUBRegions(&VisibleRgn, &VisibleRgn, ValidRgn);
+            if (!GUI_AddPixelMove(Object, Layer, ValidRgn, dXY))                                    // Painted instead
+                GDI_ADDRegions(&VisibleRgn, &VisibleRgn, ValidRgn);
         }
+        GDI_ADDRegions(&GUIDirtyRgn[Layer], &GUIDirtyRgn[Layer], &VisibleRgn);
+    }
+    GDI_FreeRegion(&VisibleRgn);
+}
+
+/*
+A top level window occupying the whole layer alone is moved by the layer offset,
+nothing is drawn. The offset register is written by the next paint pass.
+Returns false if the window can not be moved this way.
+*/
+boolean GUI_MoveWindowLayer(pWIN Win, TPOINT dXY)
+{
+    TVLINDEX Layer;
+    TRECT    OldRect, NewRect;
+    pDLITEM  Item;
+
+    if ((Win == NULL) || (Win->Head.Parent != NULL) || ((Layer = Win->Layer) >= LCDIF_NUMLAYERS) ||
+            (DL_GetItemsCount(GUIWinZOrder[Layer]) != 1) ||
+            memcmp(&Win->Head.Position, &LCDScreen.VLayer[Layer].LayerRgn, sizeof(TRECT))) return false;
+
+    OldRect = LCDIF_GetLayerScreenRect(Layer);
+    if (!LCDIF_MoveLayer(Layer, dXY.x, dXY.y, false)) return false;
+    GUICoverageChanged = true;
+
+    if (LCDScreen.VLayer[Layer].Enabled)
+    {
+        NewRect = LCDIF_GetLayerScreenRect(Layer);
+        GUI_UpdateScreen(&OldRect);
+        GUI_UpdateScreen(&NewRect);
+    }
+
+    /* The regions follow the pixels of the frame buffer */
+    GDI_TranslateRegion(&GUIDirtyRgn[Layer], dXY.x, dXY.y);
+    GDI_TranslateRegion(&GUIHiddenRgn[Layer], dXY.x, dXY.y);
+    for(Item = DL_GetFirstItem(&GUIPixMoves); Item != NULL; Item = DL_GetNextItem(Item))
+        if (((pPIXMOVE)Item->Data)->Layer == Layer)
+            GDI_TranslateRegion(&((pPIXMOVE)Item->Data)->Region, dXY.x, dXY.y);
+
+    return true;
+}
+
+/*
+Moves the layer on the screen together with its windows, nothing is repainted.
+The layer coordinates are not changed.
+*/
+boolean GUI_SetLayerOffset(TVLINDEX Layer, TPOINT Offset)
+{
+    TRECT OldRect = LCDIF_GetLayerScreenRect(Layer), NewRect;
+
+    if (!LCDIF_SetLayerOffset(Layer, Offset, false)) return false;
+    GUICoverageChanged = true;
+
+    if (LCDScreen.VLayer[Layer].Enabled)
+    {
+        NewRect = LCDIF_GetLayerScreenRect(Layer);
+        GUI_UpdateScreen(&OldRect);
+        GUI_UpdateScreen(&NewRect);
     }
+    return true;
+}
+
+boolean GUI_SetLayerAlpha(TVLINDEX Layer, uint8_t Alpha)
+{
+    TRECT LayerRect;
+
+    if (!LCDIF_SetLayerAlpha(Layer, Alpha, false)) return false;
+    GUICoverageChanged = true;
+
+    if (LCDScreen.VLayer[Layer].Enabled)
+    {
+        LayerRect = LCDIF_GetLayerScreenRect(Layer);
+        GUI_UpdateScreen(&LayerRect);
+    }
+    return true;
+}
+
+boolean GUI_SetLayerEnabled(TVLINDEX Layer, boolean Enabled)
+{
+    TRECT LayerRect;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+    if (LCDScreen.VLayer[Layer].Enabled == Enabled) return true;
+
+    if (LCDIF_SetLayerEnabled(Layer, Enabled, false) != Enabled) return false;
+    GUICoverageChanged = true;
+
+    LayerRect = LCDIF_GetLayerScreenRect(Layer);
+    GUI_UpdateScreen(&LayerRect);
+
+    return true;
+}
+
+void GUI_GetPaintStat(pPAINTSTAT Stat, boolean Reset)
+{
+    if (Stat != NULL) *Stat = GUIPaintStat;
+    if (Reset) memset(&GUIPaintStat, 0x00, sizeof(TPAINTSTAT));
 }
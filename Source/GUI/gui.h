@@ -32,10 +32,32 @@ typedef struct tag_PAINTEV
     TRECT      UpdateRect;
 } TPAINTEV, *pPAINTEV;
 
+typedef struct tag_PAINTSTAT
+{
+    uint32_t Passes;
+    uint32_t InvalidatedPixels;                                                                     // Area of the merged dirty regions
+    uint32_t PaintedPixels;                                                                         // Area drawn by the objects
+    uint32_t CulledPixels;                                                                          // Area hidden by the opaque layers above
+    uint32_t MovedPixels;                                                                           // Area copied by moving objects
+} TPAINTSTAT, *pPAINTSTAT;
+
 extern pDLIST GUIWinZOrder[LCDIF_NUMLAYERS];
 
 extern boolean GUI_Initialize(void);
 extern void GUI_Invalidate(pGUIHEADER Object, pRECT Rct);
-extern void GUI_OnPaintHandler(pPAINTEV Event);
+extern void GUI_Expose(pGUIHEADER Object, pRECT Rct);
+extern void GUI_InvalidateLayer(TVLINDEX Layer, pRECT Rct);
+extern void GUI_UpdateScreenRect(TVLINDEX Layer, pRECT Rct);
+extern void GUI_UpdateScreen(pRECT Rct);
+extern void GUI_ProcessPaint(void);
+extern boolean GUI_IsPaintPending(void);
+extern boolean GUI_GetObjectVisibleRegion(pGUIHEADER Object, pREGION Region, TVLINDEX *Layer);
+extern boolean GUI_GetObjectValidRegion(pGUIHEADER Object, pREGION Region);
+extern void GUI_MoveObjectPixels(pGUIHEADER Object, pREGION ValidRgn, TPOINT dXY);
+extern boolean GUI_SetLayerOffset(TVLINDEX Layer, TPOINT Offset);
+extern boolean GUI_SetLayerAlpha(TVLINDEX Layer, uint8_t Alpha);
+extern boolean GUI_SetLayerEnabled(TVLINDEX Layer, boolean Enabled);
+extern boolean GUI_MoveWindowLayer(pWIN Win, TPOINT dXY);
+extern void GUI_GetPaintStat(pPAINTSTAT Stat, boolean Reset);
 
 #endif /* _GUI_H_ */
@@ -0,0 +1,303 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guianim.h"
+
+
+/*
+The animations are stepped by the frame scheduler once per frame, before the paint
+pass, so all the invalidations of a frame are merged and painted together.
+The value of an animation depends on the time only, a late frame jumps further.
+The layer offset and the layer alpha are changed in hardware, only the LCD
+is updated, nothing is repainted. An object animation is replaced by a new one
+of the same property and is dropped with the object.
+*/
+
+#define ANIM_BACK1      111514                                                                      // 1.70158 in Q16, overshoot of about 10%
+#define ANIM_BACK3      (ANIM_BACK1 + ANIM_ONE)
+
+static TDLIST GUIAnimList;
+
+static int32_t GUI_MulQ16(int32_t a, int32_t b)
+{
+    return ((int64_t)a * b) >> 16;
+}
+
+/* t and the result are in Q16, 0 - the start, ANIM_ONE - the end. */
+int32_t GUI_Ease(TEASING Easing, int32_t t)
+{
+    int32_t u;
+
+    if (t <= 0) return 0;
+    if (t >= ANIM_ONE) return ANIM_ONE;
+
+    switch(Easing)
+    {
+    case AE_EASEIN:
+        return GUI_MulQ16(t, t);
+    case AE_EASEOUT:
+        u = ANIM_ONE - t;
+        return ANIM_ONE - GUI_MulQ16(u, u);
+    case AE_EASEINOUT:
+        if (t < ANIM_ONE / 2) return 2 * GUI_MulQ16(t, t);
+        u = ANIM_ONE - t;
+        return ANIM_ONE - 2 * GUI_MulQ16(u, u);
+    case AE_OVERSHOOT:
+        u = t - ANIM_ONE;
+        return ANIM_ONE + GUI_MulQ16(ANIM_BACK3, GUI_MulQ16(GUI_MulQ16(u, u), u)) +
+               GUI_MulQ16(ANIM_BACK1, GUI_MulQ16(u, u));
+    case AE_LINEAR:
+    default:
+        return t;
+    }
+}
+
+static int32_t GUI_Lerp(int32_t a, int32_t b, int32_t e)
+{
+    return a + GUI_MulQ16(b - a, e);
+}
+
+static uint32_t GUI_LerpColor(uint32_t a, uint32_t b, int32_t e)
+{
+    uint32_t Res = 0, i;
+
+    for(i = 0; i < 32; i += 8)
+    {
+        int32_t c = GUI_Lerp((a >> i) & 0xFF, (b >> i) & 0xFF, e);
+
+        Res |= (uint32_t)((c < 0) ? 0 : (c > 0xFF) ? 0xFF : c) << i;
+    }
+    return Res;
+}
+
+static void GUI_ApplyAnimation(pANIM Anim, int32_t e)
+{
+    switch(Anim->Property)
+    {
+    case AP_POSITION:
+    {
+        TRECT Position;
+
+        Position.l = GUI_Lerp(Anim->From.Rect.l, Anim->To.Rect.l, e);
+        Position.t = GUI_Lerp(Anim->From.Rect.t, Anim->To.Rect.t, e);
+        Position.r = GUI_Lerp(Anim->From.Rect.r, Anim->To.Rect.r, e);
+        Position.b = GUI_Lerp(Anim->From.Rect.b, Anim->To.Rect.b, e);
+        GUI_SetObjectPosition(Anim->Object, &Position);
+    }
+    break;
+    case AP_LAYEROFFSET:
+        GUI_SetLayerOffset(Anim->Layer, Point(GUI_Lerp(Anim->From.Point.x, Anim->To.Point.x, e),
+                                              GUI_Lerp(Anim->From.Point.y, Anim->To.Point.y, e)));
+        break;
+    case AP_LAYERALPHA:
+    {
+        int32_t Alpha = GUI_Lerp(Anim->From.Value, Anim->To.Value, e);
+
+        GUI_SetLayerAlpha(Anim->Layer, (Alpha < 0) ? 0 : (Alpha > 0xFF) ? 0xFF : Alpha);
+    }
+    break;
+    case AP_COLOR:
+    {
+        uint32_t Color = GUI_LerpColor(Anim->From.Value, Anim->To.Value, e);
+
+        if (*Anim->Color != Color)
+        {
+            *Anim->Color = Color;
+            GUI_Invalidate(Anim->Object, NULL);
+        }
+    }
+    break;
+    }
+}
+
+static boolean GUI_IsSameAnimation(pANIM a, pANIM b)
+{
+    if (a->Property != b->Property) return false;
+
+    switch(a->Property)
+    {
+    case AP_LAYEROFFSET:
+    case AP_LAYERALPHA:
+        return a->Layer == b->Layer;
+    case AP_COLOR:
+        return a->Color == b->Color;
+    default:
+        return a->Object == b->Object;
+    }
+}
+
+static pANIM GUI_StartAnimation(pANIM Template)
+{
+    pANIM   Anim;
+    pDLITEM tmpItem = DL_GetFirstItem(&GUIAnimList);
+
+    while(tmpItem != NULL)
+    {
+        pANIM OldAnim = (pANIM)tmpItem->Data;
+
+        tmpItem = DL_GetNextItem(tmpItem);
+        if (GUI_IsSameAnimation(OldAnim, Template)) GUI_StopAnimation(OldAnim, false);
+    }
+
+    Anim = malloc(sizeof(TANIM));
+    if (Anim == NULL) return NULL;
+
+    *Anim = *Template;
+    Anim->StartTicks = USC_GetCurrentTicks();
+    if (DL_AddItem(&GUIAnimList, Anim) == NULL)
+    {
+        free(Anim);
+        return NULL;
+    }
+    return Anim;
+}
+
+/* Duration in ms. Position is relative to the parent, as in GUI_SetObjectPosition(). */
+pANIM GUI_AnimatePosition(pGUIHEADER Object, TRECT To, uint32_t Duration, TEASING Easing,
+                          void (*OnFinish)(pANIM))
+{
+    TANIM Anim = {0};
+
+    if (!GUI_GetObjectPosition(Object, &Anim.From.Rect)) return NULL;
+
+    Anim.Property = AP_POSITION;
+    Anim.Easing = Easing;
+    Anim.Object = Object;
+    Anim.To.Rect = To;
+    Anim.Duration = Duration * 1000;
+    Anim.OnFinish = OnFinish;
+
+    return GUI_StartAnimation(&Anim);
+}
+
+/* To is the layer offset, as in LCDIF_SetupLayer(). */
+pANIM GUI_AnimateLayerOffset(TVLINDEX Layer, TPOINT To, uint32_t Duration, TEASING Easing,
+                             void (*OnFinish)(pANIM))
+{
+    TANIM Anim = {0};
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return NULL;
+
+    Anim.Property = AP_LAYEROFFSET;
+    Anim.Easing = Easing;
+    Anim.Layer = Layer;
+    Anim.From.Point = LCDScreen.VLayer[Layer].LayerOffset;
+    Anim.To.Point = To;
+    Anim.Duration = Duration * 1000;
+    Anim.OnFinish = OnFinish;
+
+    return GUI_StartAnimation(&Anim);
+}
+
+pANIM GUI_AnimateLayerAlpha(TVLINDEX Layer, uint8_t To, uint32_t Duration, TEASING Easing,
+                            void (*OnFinish)(pANIM))
+{
+    TANIM Anim = {0};
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return NULL;
+
+    Anim.Property = AP_LAYERALPHA;
+    Anim.Easing = Easing;
+    Anim.Layer = Layer;
+    Anim.From.Value = LCDIF_GetLayerAlpha(Layer);
+    Anim.To.Value = To;
+    Anim.Duration = Duration * 1000;
+    Anim.OnFinish = OnFinish;
+
+    return GUI_StartAnimation(&Anim);
+}
+
+/* Color points to a color field of the Object, the Object is repainted on every change. */
+pANIM GUI_AnimateColor(pGUIHEADER Object, uint32_t *Color, uint32_t To, uint32_t Duration,
+                       TEASING Easing, void (*OnFinish)(pANIM))
+{
+    TANIM Anim = {0};
+
+    if ((Object == NULL) || (Color == NULL)) return NULL;
+
+    Anim.Property = AP_COLOR;
+    Anim.Easing = Easing;
+    Anim.Object = Object;
+    Anim.Color = Color;
+    Anim.From.Value = *Color;
+    Anim.To.Value = To;
+    Anim.Duration = Duration * 1000;
+    Anim.OnFinish = OnFinish;
+
+    return GUI_StartAnimation(&Anim);
+}
+
+/* A completed animation is set to its final value and OnFinish is called. */
+void GUI_StopAnimation(pANIM Anim, boolean Complete)
+{
+    if ((Anim == NULL) || !DL_DeleteItemByData(&GUIAnimList, Anim)) return;
+
+    if (Complete)
+    {
+        GUI_ApplyAnimation(Anim, ANIM_ONE);
+        if (Anim->OnFinish != NULL) Anim->OnFinish(Anim);
+    }
+    free(Anim);
+}
+
+/* Drops the animations of the object without completing them. */
+void GUI_StopObjectAnimations(pGUIHEADER Object)
+{
+    pDLITEM tmpItem = DL_GetFirstItem(&GUIAnimList);
+
+    if (Object == NULL) return;
+
+    while(tmpItem != NULL)
+    {
+        pANIM Anim = (pANIM)tmpItem->Data;
+
+        tmpItem = DL_GetNextItem(tmpItem);
+        if (Anim->Object == Object) GUI_StopAnimation(Anim, false);
+    }
+}
+
+boolean GUI_IsAnimating(void)
+{
+    return DL_GetItemsCount(&GUIAnimList) != 0;
+}
+
+void GUI_ProcessAnimations(void)
+{
+    int32_t Ticks = USC_GetCurrentTicks();
+    pDLITEM tmpItem = DL_GetFirstItem(&GUIAnimList);
+
+    while(tmpItem != NULL)
+    {
+        pANIM    Anim = (pANIM)tmpItem->Data;
+        uint32_t Elapsed = Ticks - Anim->StartTicks;
+
+        if (Elapsed < Anim->Duration)
+        {
+            GUI_ApplyAnimation(Anim, GUI_Ease(Anim->Easing, ((uint64_t)Elapsed << 16) / Anim->Duration));
+            tmpItem = DL_GetNextItem(tmpItem);
+        }
+        else
+        {
+            GUI_StopAnimation(Anim, true);
+            tmpItem = DL_GetFirstItem(&GUIAnimList);                                                // OnFinish may change the list
+        }
+    }
+}
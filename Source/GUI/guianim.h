@@ -0,0 +1,78 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUIANIM_H_
+#define _GUIANIM_H_
+
+#define ANIM_ONE            0x10000                                                                 // 1.0 in Q16
+
+typedef enum tag_ANIMPROP
+{
+    AP_POSITION,                                                                                    // Object position relative to its parent
+    AP_LAYEROFFSET,                                                                                 // Screen position of the layer
+    AP_LAYERALPHA,
+    AP_COLOR                                                                                        // Color field of the object
+} TANIMPROP;
+
+typedef enum tag_EASING
+{
+    AE_LINEAR,
+    AE_EASEIN,
+    AE_EASEOUT,
+    AE_EASEINOUT,
+    AE_OVERSHOOT                                                                                    // Passes the target and returns to it
+} TEASING;
+
+typedef union tag_ANIMVALUE
+{
+    TRECT    Rect;                                                                                  // AP_POSITION
+    TPOINT   Point;                                                                                 // AP_LAYEROFFSET
+    uint32_t Value;                                                                                 // AP_LAYERALPHA, AP_COLOR
+} TANIMVALUE, *pANIMVALUE;
+
+typedef struct tag_ANIM *pANIM;
+typedef struct tag_ANIM
+{
+    TANIMPROP  Property;
+    TEASING    Easing;
+    pGUIHEADER Object;                                                                              // AP_POSITION, AP_COLOR
+    TVLINDEX   Layer;                                                                               // AP_LAYEROFFSET, AP_LAYERALPHA
+    uint32_t   *Color;                                                                              // AP_COLOR
+    TANIMVALUE From;
+    TANIMVALUE To;
+    uint32_t   Duration;                                                                            // In us
+    int32_t    StartTicks;
+    int32_t    Tag;
+    void       (*OnFinish)(pANIM);
+} TANIM, *pANIM;
+
+extern int32_t GUI_Ease(TEASING Easing, int32_t t);
+extern pANIM GUI_AnimatePosition(pGUIHEADER Object, TRECT To, uint32_t Duration, TEASING Easing,
+                                 void (*OnFinish)(pANIM));
+extern pANIM GUI_AnimateLayerOffset(TVLINDEX Layer, TPOINT To, uint32_t Duration, TEASING Easing,
+                                    void (*OnFinish)(pANIM));
+extern pANIM GUI_AnimateLayerAlpha(TVLINDEX Layer, uint8_t To, uint32_t Duration, TEASING Easing,
+                                   void (*OnFinish)(pANIM));
+extern pANIM GUI_AnimateColor(pGUIHEADER Object, uint32_t *Color, uint32_t To, uint32_t Duration,
+                              TEASING Easing, void (*OnFinish)(pANIM));
+extern void GUI_StopAnimation(pANIM Anim, boolean Complete);
+extern void GUI_StopObjectAnimations(pGUIHEADER Object);
+extern boolean GUI_IsAnimating(void);
+extern void GUI_ProcessAnimations(void);
+
+#endif /* _GUIANIM_H_ */
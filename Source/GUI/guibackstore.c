@@ -0,0 +1,185 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guibackstore.h"
+
+/*
+A retained window keeps its rendered content in an off-screen bitmap of the layer
+format, an exposed window is drawn by copying it. The content is rendered again
+only after the window is invalidated or resized. All bitmaps share one budget,
+the least recently used ones are freed when it is exceeded.
+*/
+
+static pBACKSTORE       BackStoreHead, BackStoreTail;                                               // LRU list, the head is the most recently used
+static TBACKSTORESTAT   BackStoreStat = {0, 0, 0, 0, 0, BackStoreBudget};
+
+static void GUI_UnlinkBackStore(pBACKSTORE Store)
+{
+    if (Store->Prev != NULL) Store->Prev->Next = Store->Next;
+    else BackStoreHead = Store->Next;
+    if (Store->Next != NULL) Store->Next->Prev = Store->Prev;
+    else BackStoreTail = Store->Prev;
+    Store->Prev = Store->Next = NULL;
+}
+
+static void GUI_LinkBackStore(pBACKSTORE Store)
+{
+    Store->Prev = NULL;
+    Store->Next = BackStoreHead;
+    if (BackStoreHead != NULL) BackStoreHead->Prev = Store;
+    else BackStoreTail = Store;
+    BackStoreHead = Store;
+}
+
+static void GUI_FreeBackStoreData(pBACKSTORE Store)
+{
+    if (Store->Bitmap.Data == NULL) return;
+
+    GUI_UnlinkBackStore(Store);
+    free(Store->Bitmap.Data);
+    Store->Bitmap.Data = NULL;
+    Store->Valid = false;
+    BackStoreStat.Used -= Store->Size;
+    BackStoreStat.Count--;
+}
+
+static void GUI_EvictBackStores(uint32_t Size)
+{
+    while((BackStoreTail != NULL) && (BackStoreStat.Used + Size > BackStoreStat.Budget))
+    {
+        GUI_FreeBackStoreData(BackStoreTail);
+        BackStoreStat.Evictions++;
+    }
+}
+
+static boolean GUI_AllocBackStoreData(pBACKSTORE Store, pLCONTEXT lc)
+{
+    TRECT    *Pos = &Store->Win->Head.Position;
+    uint16_t Width = Pos->r - Pos->l + 1, Height = Pos->b - Pos->t + 1;
+    uint32_t Size = Width * Height * lc->BPP;
+
+    if ((Store->Bitmap.Data != NULL) && (Store->Bitmap.Width == Width) &&
+            (Store->Bitmap.Height == Height) && (Store->Bitmap.ColorFormat == lc->ColorFormat))
+        return true;
+
+    GUI_FreeBackStoreData(Store);
+    if ((Size == 0) || (Size > BackStoreStat.Budget)) return false;
+
+    GUI_EvictBackStores(Size);
+    Store->Bitmap.Data = malloc(Size);
+    if (Store->Bitmap.Data == NULL) return false;
+
+    Store->Bitmap.ColorFormat = lc->ColorFormat;
+    Store->Bitmap.Width = Width;
+    Store->Bitmap.Height = Height;
+    Store->Bitmap.Stride = Width * lc->BPP;
+    Store->Size = Size;
+    Store->Valid = false;
+    GUI_LinkBackStore(Store);
+    BackStoreStat.Used += Size;
+    BackStoreStat.Count++;
+
+    return true;
+}
+
+/* The layer is redirected to the bitmap while the window paints itself. */
+static void GUI_RenderBackStore(pBACKSTORE Store, pLCONTEXT lc)
+{
+    TLCONTEXT Saved = *lc;
+    TRECT     Pos = Store->Win->Head.Position;
+
+    lc->FrameBuffer = Store->Bitmap.Data;
+    lc->LayerRgn = Pos;
+    GUI_PaintObject(&Store->Win->Head, &Pos);
+    *lc = Saved;
+
+    Store->Valid = true;
+    BackStoreStat.Renders++;
+}
+
+boolean GUI_SetWindowRetained(pWIN Win, boolean Retained)
+{
+    if ((Win == NULL) || !IsWindowObject((pGUIHEADER)Win)) return false;
+
+    if (!Retained) GUI_FreeBackStore(Win);
+    else if (Win->BackStore == NULL)
+    {
+        Win->BackStore = malloc(sizeof(TBACKSTORE));
+        if (Win->BackStore == NULL) return false;
+        memset(Win->BackStore, 0x00, sizeof(TBACKSTORE));
+        Win->BackStore->Win = Win;
+    }
+    return true;
+}
+
+void GUI_FreeBackStore(pWIN Win)
+{
+    if ((Win == NULL) || (Win->BackStore == NULL)) return;
+
+    GUI_FreeBackStoreData(Win->BackStore);
+    free(Win->BackStore);
+    Win->BackStore = NULL;
+}
+
+/* The content of the window is changed, it is rendered again on the next draw. */
+void GUI_DropBackStore(pWIN Win)
+{
+    if ((Win != NULL) && (Win->BackStore != NULL)) Win->BackStore->Valid = false;
+}
+
+/* Returns false if the window has to be painted directly. */
+boolean GUI_DrawFromBackStore(pWIN Win, pRECT Clip)
+{
+    pBACKSTORE Store;
+    pLCONTEXT  lc;
+    TRECT      tmpRect;
+
+    if ((Win == NULL) || ((Store = Win->BackStore) == NULL) || (Clip == NULL) ||
+            (Win->Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Win->Layer].Initialized) return false;
+
+    lc = &LCDScreen.VLayer[Win->Layer];
+    if (!GUI_AllocBackStoreData(Store, lc)) return false;
+
+    if (!Store->Valid) GUI_RenderBackStore(Store, lc);
+    else BackStoreStat.Hits++;
+
+    GUI_UnlinkBackStore(Store);
+    GUI_LinkBackStore(Store);
+
+    tmpRect = *Clip;
+    if (GDI_ANDRectangles(&tmpRect, &Win->Head.Position) && GDI_ANDRectangles(&tmpRect, &lc->LayerRgn))
+    {
+        GDI_BitBltX(lc, &tmpRect, &Store->Bitmap,
+                    Point(tmpRect.l - Win->Head.Position.l, tmpRect.t - Win->Head.Position.t), BM_COPY, 0);
+    }
+    return true;
+}
+
+void GUI_SetBackStoreBudget(uint32_t Budget)
+{
+    BackStoreStat.Budget = Budget;
+    GUI_EvictBackStores(0);
+}
+
+void GUI_GetBackStoreStat(pBACKSTORESTAT Stat)
+{
+    if (Stat != NULL) *Stat = BackStoreStat;
+}
@@ -0,0 +1,49 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUIBACKSTORE_H_
+#define _GUIBACKSTORE_H_
+
+typedef struct tag_BACKSTORE
+{
+    pWIN       Win;
+    pBACKSTORE Prev;
+    pBACKSTORE Next;
+    uint32_t   Size;                                                                                // Bytes of the bitmap
+    boolean    Valid;                                                                               // The bitmap holds the current content
+    TBITMAP    Bitmap;                                                                              // Data == NULL - not allocated or evicted
+} TBACKSTORE;
+
+typedef struct tag_BACKSTORESTAT
+{
+    uint32_t Hits;
+    uint32_t Renders;
+    uint32_t Evictions;
+    uint32_t Count;                                                                                 // Allocated bitmaps
+    uint32_t Used;                                                                                  // Bytes
+    uint32_t Budget;                                                                                // Bytes
+} TBACKSTORESTAT, *pBACKSTORESTAT;
+
+extern boolean GUI_SetWindowRetained(pWIN Win, boolean Retained);
+extern void GUI_FreeBackStore(pWIN Win);
+extern void GUI_DropBackStore(pWIN Win);
+extern boolean GUI_DrawFromBackStore(pWIN Win, pRECT Clip);
+extern void GUI_SetBackStoreBudget(uint32_t Budget);
+extern void GUI_GetBackStoreStat(pBACKSTORESTAT Stat);
+
+#endif /* _GUIBACKSTORE_H_ */
@@ -0,0 +1,126 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guiframe.h"
+
+
+/*
+The main loop paints at most one frame per frame slot. The event handlers only record
+the changes (the dirty regions, the moved pixels, the layer settings), the paint pass
+of the frame writes them to the frame buffers and the layer registers. A new frame is
+not started while the updates of the previous one are still being sent to the LCD
+(its LCDIF fence is not reached), so a running transfer does not see the changes and
+the changes of the slot are merged into one update. The wait does not block the main loop,
+the sent frame is reported to the frame handler from the main loop as well.
+Running animations keep the frames going. With no pending changes the schedule is restarted,
+so the first change after an idle period is painted at once and is not counted as dropped frames.
+*/
+
+static TFRAMESTAT GUIFrameStat;
+static uint32_t   GUIFrameInterval = (GUIFrameRate) ? 1000000 / GUIFrameRate : 0;                   // In us, 0 - no pacing
+static int32_t    GUINextFrameTicks;
+static int32_t    GUILastFrameTicks;
+static boolean    GUIFrameStalled;
+static boolean    GUIFrameIdle = true;                                                              // Nothing was pending on the last pass
+static uint32_t   GUIFrameNumber;                                                                   // The last painted frame
+static uint32_t   GUIFrameSent;                                                                     // The last frame sent to the LCD
+static uint32_t   GUIFrameFence;                                                                    // LCDIF fence of the last painted frame
+static void       (*GUIFrameHandler)(uint32_t);
+
+void GUI_SetFrameRate(uint32_t FPS)
+{
+    GUIFrameInterval = (FPS) ? 1000000 / FPS : 0;
+    GUINextFrameTicks = USC_GetCurrentTicks();
+}
+
+/* The Handler is called with the number of the frame once its updates are sent to the LCD. */
+void GUI_SetFrameHandler(void (*Handler)(uint32_t))
+{
+    GUIFrameHandler = Handler;
+}
+
+uint32_t GUI_GetFrameNumber(void)
+{
+    return GUIFrameNumber;
+}
+
+boolean GUI_IsFrameSent(uint32_t Frame)
+{
+    return (int32_t)(GUIFrameSent - Frame) >= 0;
+}
+
+void GUI_ProcessFrame(void)
+{
+    int32_t Ticks = USC_GetCurrentTicks();
+    int32_t Late;
+
+    if ((GUIFrameSent != GUIFrameNumber) && LCDIF_IsFenceReached(GUIFrameFence))
+    {
+        GUIFrameSent = GUIFrameNumber;
+        if (GUIFrameHandler != NULL) GUIFrameHandler(GUIFrameSent);
+    }
+
+    if (!GUI_IsPaintPending() && !GUI_IsAnimating())
+    {
+        GUIFrameIdle = true;
+        return;
+    }
+    if (GUIFrameIdle) GUINextFrameTicks = Ticks;
+    GUIFrameIdle = false;
+
+    Late = Ticks - GUINextFrameTicks;
+    if (GUIFrameInterval && (Late < 0)) return;                                                     // The frame slot is not reached yet
+    if (GUIFrameSent != GUIFrameNumber)                                                             // The previous frame is still being sent
+    {
+        if (!GUIFrameStalled) GUIFrameStat.Stalls++;
+        GUIFrameStalled = true;
+        return;
+    }
+    GUIFrameStalled = false;
+
+    if (GUIFrameInterval)
+    {
+        uint32_t Missed = (uint32_t)Late / GUIFrameInterval;
+
+        GUIFrameStat.Dropped += Missed;
+        GUINextFrameTicks += (Missed + 1) * GUIFrameInterval;
+    }
+    GUIFrameStat.FrameTime = Ticks - GUILastFrameTicks;
+    GUILastFrameTicks = Ticks;
+
+    GUI_ProcessAnimations();
+    GUI_UpdateDebugOverlay(&GUIFrameStat, GUIFrameInterval);                                        // Sent to the screen with the frame
+
+    Ticks = USC_GetCurrentTicks();
+    GUI_ProcessPaint();
+    GUIFrameStat.PaintTime = USC_GetCurrentTicks() - Ticks;
+    if (GUIFrameStat.PaintTime > GUIFrameStat.MaxPaintTime)
+        GUIFrameStat.MaxPaintTime = GUIFrameStat.PaintTime;
+    GUIFrameStat.Frames++;
+    GUIFrameNumber++;
+    GUIFrameFence = LCDIF_GetFence();
+}
+
+void GUI_GetFrameStat(pFRAMESTAT Stat, boolean Reset)
+{
+    if (Stat != NULL) *Stat = GUIFrameStat;
+    if (Reset) memset(&GUIFrameStat, 0x00, sizeof(TFRAMESTAT));
+}
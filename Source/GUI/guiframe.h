@@ -0,0 +1,39 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUIFRAME_H_
+#define _GUIFRAME_H_
+
+typedef struct tag_FRAMESTAT
+{
+    uint32_t Frames;                                                                                // Painted frames
+    uint32_t Dropped;                                                                               // Frame slots missed by the main loop
+    uint32_t Stalls;                                                                                // Frames delayed by the running LCD transfer
+    uint32_t FrameTime;                                                                             // Time between the last two frames in us
+    uint32_t PaintTime;                                                                             // Time of the last paint pass in us
+    uint32_t MaxPaintTime;
+} TFRAMESTAT, *pFRAMESTAT;
+
+extern void GUI_SetFrameRate(uint32_t FPS);
+extern void GUI_SetFrameHandler(void (*Handler)(uint32_t));
+extern uint32_t GUI_GetFrameNumber(void);
+extern boolean GUI_IsFrameSent(uint32_t Frame);
+extern void GUI_ProcessFrame(void);
+extern void GUI_GetFrameStat(pFRAMESTAT Stat, boolean Reset);
+
+#endif /* _GUIFRAME_H_ */
@@ -0,0 +1,209 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guigrid.h"
+
+/*
+Every layer is split into fixed cells, each cell keeps the top level windows
+overlapping it. Coordinates outside of the screen are clamped to the border
+cells, so windows larger than the screen are still found.
+The z-order of windows is given by ZKey: the higher key is closer to the top.
+*/
+
+#define GRID_CELLGROW   4
+
+typedef struct tag_GRIDCELL
+{
+    uint16_t Count;
+    uint16_t Size;
+    pWIN     *Items;
+} TGRIDCELL, *pGRIDCELL;
+
+static TGRIDCELL GUIGrid[LCDIF_NUMLAYERS][GRID_ROWS][GRID_COLS];
+static uint32_t  GridZCounter = GRID_ZBASE;
+static uint32_t  GridZBottom = GRID_ZBASE;                                                          // Keys of the windows sent to the bottom go down
+static uint32_t  GridQueryMark;
+
+static int32_t GUI_GridCell(int32_t v, int32_t Limit)
+{
+    v = (v < 0) ? 0 : v >> GRID_CELLSHIFT;
+    return (v >= Limit) ? Limit - 1 : v;
+}
+
+static boolean GUI_GridCellsOfRect(pRECT Rct, pRECT Cells)
+{
+    if ((Rct->l > Rct->r) || (Rct->t > Rct->b)) return false;
+
+    Cells->l = GUI_GridCell(Rct->l, GRID_COLS);
+    Cells->r = GUI_GridCell(Rct->r, GRID_COLS);
+    Cells->t = GUI_GridCell(Rct->t, GRID_ROWS);
+    Cells->b = GUI_GridCell(Rct->b, GRID_ROWS);
+
+    return true;
+}
+
+static boolean GUI_GridAddToCell(pGRIDCELL Cell, pWIN Win)
+{
+    if (Cell->Count >= Cell->Size)
+    {
+        pWIN *NewItems = realloc(Cell->Items, (Cell->Size + GRID_CELLGROW) * sizeof(pWIN));
+
+        if (NewItems == NULL) return false;
+        Cell->Items = NewItems;
+        Cell->Size += GRID_CELLGROW;
+    }
+    Cell->Items[Cell->Count++] = Win;
+
+    return true;
+}
+
+static void GUI_GridDeleteFromCell(pGRIDCELL Cell, pWIN Win)
+{
+    uint32_t i;
+
+    for(i = 0; i < Cell->Count; i++)
+    {
+        if (Cell->Items[i] == Win)
+        {
+            Cell->Items[i] = Cell->Items[--Cell->Count];                                            // The order of the items does not matter
+            break;
+        }
+    }
+}
+
+uint32_t GUI_GridNewZKey(boolean Topmost)
+{
+    GridZCounter = (GridZCounter + 1) & ~GRID_ZTOPMOST;
+
+    return (Topmost) ? GridZCounter | GRID_ZTOPMOST : GridZCounter;
+}
+
+uint32_t GUI_GridNewBottomZKey(boolean Topmost)
+{
+    GridZBottom = (GridZBottom - 1) & ~GRID_ZTOPMOST;
+
+    return (Topmost) ? GridZBottom | GRID_ZTOPMOST : GridZBottom;
+}
+
+boolean GUI_GridInsertWindow(pWIN Win)
+{
+    TRECT   Cells;
+    int32_t x, y;
+
+    if ((Win == NULL) || (Win->Head.Parent != NULL) || (Win->Layer >= LCDIF_NUMLAYERS)) return false;
+    if (!GUI_GridCellsOfRect(&Win->Head.Position, &Cells)) return true;
+
+    for(y = Cells.t; y <= Cells.b; y++)
+    {
+        for(x = Cells.l; x <= Cells.r; x++)
+        {
+            if (!GUI_GridAddToCell(&GUIGrid[Win->Layer][y][x], Win))
+            {
+                Win->GridCells = Cells;                                                             // Cells without the window are skipped
+                GUI_GridRemoveWindow(Win);
+                return false;
+            }
+        }
+    }
+    Win->GridCells = Cells;
+
+    return true;
+}
+
+void GUI_GridRemoveWindow(pWIN Win)
+{
+    int32_t x, y;
+
+    if ((Win == NULL) || (Win->Layer >= LCDIF_NUMLAYERS)) return;
+
+    for(y = Win->GridCells.t; y <= Win->GridCells.b; y++)
+        for(x = Win->GridCells.l; x <= Win->GridCells.r; x++)
+            GUI_GridDeleteFromCell(&GUIGrid[Win->Layer][y][x], Win);
+
+    Win->GridCells = Rect(0, 0, -1, -1);
+}
+
+boolean GUI_GridUpdateWindow(pWIN Win)
+{
+    TRECT Cells;
+
+    if ((Win == NULL) || (Win->Head.Parent != NULL)) return false;
+
+    if (GUI_GridCellsOfRect(&Win->Head.Position, &Cells) &&
+            !memcmp(&Cells, &Win->GridCells, sizeof(TRECT)))
+        return true;                                                                                // Still in the same cells
+
+    GUI_GridRemoveWindow(Win);
+    return GUI_GridInsertWindow(Win);
+}
+
+pWIN GUI_GridWindowFromPoint(TVLINDEX Layer, int16_t x, int16_t y)
+{
+    pGRIDCELL Cell;
+    pWIN      Res = NULL;
+    uint32_t  i;
+
+    if (Layer >= LCDIF_NUMLAYERS) return NULL;
+
+    Cell = &GUIGrid[Layer][GUI_GridCell(y, GRID_ROWS)][GUI_GridCell(x, GRID_COLS)];
+    for(i = 0; i < Cell->Count; i++)
+    {
+        pWIN Win = Cell->Items[i];
+
+        if (Win->Head.Visible && IsPointInRect(x, y, &Win->Head.Position) &&
+                ((Res == NULL) || (Win->ZKey > Res->ZKey)))
+            Res = Win;
+    }
+    return Res;
+}
+
+/* Subtracts from the region all visible windows lying above Win in its layer. */
+boolean GUI_GridSubWindowsAbove(pREGION Region, pWIN Win)
+{
+    TRECT   Cells;
+    int32_t x, y;
+
+    if ((Region == NULL) || (Win == NULL) || (Win->Layer >= LCDIF_NUMLAYERS)) return false;
+    if (!GUI_GridCellsOfRect(&Region->Extent, &Cells) || GDI_IsRegionEmpty(Region)) return false;
+
+    GridQueryMark++;
+    for(y = Cells.t; y <= Cells.b; y++)
+    {
+        for(x = Cells.l; x <= Cells.r; x++)
+        {
+            pGRIDCELL Cell = &GUIGrid[Win->Layer][y][x];
+            uint32_t  i;
+
+            for(i = 0; i < Cell->Count; i++)
+            {
+                pWIN tmpWin = Cell->Items[i];
+
+                if (tmpWin->GridMark == GridQueryMark) continue;                                    // Already visited in another cell
+                tmpWin->GridMark = GridQueryMark;
+
+                if ((tmpWin->ZKey > Win->ZKey) && tmpWin->Head.Visible &&
+                        !GDI_SUBRectFromRegion(Region, &tmpWin->Head.Position))
+                    return false;
+            }
+        }
+    }
+    return true;
+}
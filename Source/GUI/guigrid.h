@@ -0,0 +1,37 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUIGRID_H_
+#define _GUIGRID_H_
+
+#define GRID_CELLSHIFT  5                                                                           // 32x32 pixels per cell
+#define GRID_COLS       ((LCD_XRESOLUTION + (1 << GRID_CELLSHIFT) - 1) >> GRID_CELLSHIFT)
+#define GRID_ROWS       ((LCD_YRESOLUTION + (1 << GRID_CELLSHIFT) - 1) >> GRID_CELLSHIFT)
+
+#define GRID_ZTOPMOST   0x80000000                                                                  // Z-key bit of topmost windows
+#define GRID_ZBASE      0x40000000                                                                  // Keys grow up from it for raised windows and down for lowered ones
+
+extern uint32_t GUI_GridNewZKey(boolean Topmost);
+extern uint32_t GUI_GridNewBottomZKey(boolean Topmost);
+extern boolean GUI_GridInsertWindow(pWIN Win);
+extern void GUI_GridRemoveWindow(pWIN Win);
+extern boolean GUI_GridUpdateWindow(pWIN Win);
+extern pWIN GUI_GridWindowFromPoint(TVLINDEX Layer, int16_t x, int16_t y);
+extern boolean GUI_GridSubWindowsAbove(pREGION Region, pWIN Win);
+
+#endif /* _GUIGRID_H_ */
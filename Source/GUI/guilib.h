@@ -21,9 +21,21 @@
 
 #include "gditypes.h"
 #include "gdiutils.h"
+#include "gdiregion.h"
+#include "gdiblit.h"
 #include "guiobject.h"
+#include "guigrid.h"
+#include "guibackstore.h"
 #include "gdi.h"
+#include "bfcfont.h"
+#include "gdifont.h"
 #include "gui.h"
+#include "guitouch.h"
+#include "guilistview.h"
+#include "guiwidgets.h"
+#include "guiframe.h"
+#include "guioverlay.h"
+#include "guianim.h"
 
 
 #endif /* _GUILIB_H_ */
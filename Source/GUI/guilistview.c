@@ -0,0 +1,383 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guilistview.h"
+
+/*
+The list is scrolled by moving the valid pixels of the view, only the rows
+coming in view are painted. The pixels are moved by the paint pass, so the pen
+moves and the fling steps of one frame shift them once. After the pen is released
+with some speed the list keeps scrolling with deceleration. The fling is stepped
+by a timer shared by all the lists: a new fling takes it over from the previous list.
+*/
+
+static pTIMER    LVFlingTimer;
+static pLISTVIEW LVFlingList;
+
+static TVLINDEX GUI_GetListViewLayer(pLISTVIEW List)
+{
+    return ((pWIN)List->Head.Parent)->Layer;
+}
+
+static int32_t GUI_GetListViewHeight(pLISTVIEW List)
+{
+    return List->Head.Position.b - List->Head.Position.t + 1;
+}
+
+static int32_t GUI_GetListViewMaxScroll(pLISTVIEW List)
+{
+    int32_t MaxScroll = (int32_t)List->ItemCount * List->ItemHeight - GUI_GetListViewHeight(List);
+
+    return max(MaxScroll, 0);
+}
+
+static TRECT GUI_GetListViewItemRect(pLISTVIEW List, uint32_t Index)
+{
+    int32_t t = List->Head.Position.t + (int32_t)Index * List->ItemHeight - List->ScrollPos;
+
+    return Rect(List->Head.Position.l, t, List->Head.Position.r, t + List->ItemHeight - 1);
+}
+
+static int32_t GUI_GetListViewItemFromY(pLISTVIEW List, int16_t y)
+{
+    int32_t Index = (List->ScrollPos + y) / List->ItemHeight;                                       // y - relative to the list
+
+    return ((y < 0) || (Index >= (int32_t)List->ItemCount)) ? -1 : Index;
+}
+
+/* Rows for every item partially visible at the top and at the bottom of the view. */
+static boolean GUI_UpdateListViewRows(pLISTVIEW List)
+{
+    uint32_t Count = GUI_GetListViewHeight(List) / List->ItemHeight + 2;
+    uint32_t i;
+    pLISTROW NewRows;
+
+    if (Count <= List->RowCount) return true;
+
+    NewRows = realloc(List->Rows, Count * sizeof(TLISTROW));
+    if (NewRows == NULL) return false;
+
+    List->Rows = NewRows;
+    for(i = 0; i < Count; i++)
+    {
+        if (i >= List->RowCount) List->Rows[i].Text = NULL;
+        List->Rows[i].Index = -1;                                                                   // Items are moved to other rows
+    }
+    List->RowCount = Count;
+
+    return true;
+}
+
+static void GUI_ResetListViewRows(pLISTVIEW List)
+{
+    uint32_t i;
+
+    for(i = 0; i < List->RowCount; i++) List->Rows[i].Index = -1;
+}
+
+static pTEXT GUI_GetListViewRowText(pLISTVIEW List, uint32_t Index)
+{
+    pLISTROW Row;
+    int16_t  Width = List->Head.Position.r - List->Head.Position.l + 1 - 2 * LV_TEXTMARGIN;
+
+    if ((List->RowCount == 0) || (List->GetItemText == NULL)) return NULL;
+
+    Row = &List->Rows[Index % List->RowCount];
+    if (Row->Index != (int32_t)Index)
+    {
+        wchar_t *String = List->GetItemText(List, Index);
+
+        Row->Index = -1;
+        if (Row->Text == NULL)
+        {
+            Row->Text = GDI_CreateText(List->Font, String, AH_LEFT | AV_CENTER, TXF_ELLIPSIS, Width, 1);
+            if (Row->Text == NULL) return NULL;
+        }
+        else if (!GDI_SetTextString(Row->Text, String)) return NULL;
+        Row->Index = Index;
+    }
+    GDI_SetTextFont(Row->Text, List->Font);
+    GDI_SetTextWidth(Row->Text, Width);
+
+    return Row->Text;
+}
+
+static void GUI_InvalidateListViewRect(pLISTVIEW List, uint32_t Index)
+{
+    TRECT ItemRect;
+
+    if ((Index >= List->ItemCount) ||
+            ((int32_t)Index * List->ItemHeight >= List->ScrollPos + GUI_GetListViewHeight(List)) ||
+            ((int32_t)(Index + 1) * List->ItemHeight <= List->ScrollPos)) return;                   // Out of view
+
+    ItemRect = GUI_GetListViewItemRect(List, Index);
+    GUI_Invalidate(&List->Head, &ItemRect);
+}
+
+static void GUI_SetListViewPressed(pLISTVIEW List, int32_t Index)
+{
+    if (List->Pressed == Index) return;
+
+    if (List->Pressed >= 0) GUI_InvalidateListViewRect(List, List->Pressed);
+    List->Pressed = Index;
+    if (Index >= 0) GUI_InvalidateListViewRect(List, Index);
+}
+
+static void GUI_ListViewFlingStep(pTIMER Timer)
+{
+    pLISTVIEW List = LVFlingList;
+    int32_t   Step;
+
+    if (List == NULL)
+    {
+        LRT_Stop(Timer);
+        return;
+    }
+
+    List->FlingRest += List->Velocity * LV_FLINGINTERVAL;
+    Step = List->FlingRest / 1000;
+    List->FlingRest -= Step * 1000;
+    List->Velocity -= List->Velocity / LV_FLINGFRICTION;
+
+    if (!GUI_ScrollListView(List, List->ScrollPos + Step) ||                                        // The end of the list is reached
+            (abs(List->Velocity) < LV_MINFLINGSPEED))
+        GUI_StopListViewFling(List);
+}
+
+static boolean GUI_StartListViewFling(pLISTVIEW List)
+{
+    if (LVFlingTimer == NULL)
+        LVFlingTimer = LRT_Create(LV_FLINGINTERVAL, NULL, GUI_ListViewFlingStep, TF_AUTOREPEAT);
+    if (LVFlingTimer == NULL) return false;
+
+    if (LVFlingList != NULL) LVFlingList->Velocity = 0;
+    LVFlingList = List;
+    List->FlingRest = 0;
+
+    return LRT_Start(LVFlingTimer);
+}
+
+static void GUI_ListViewOnPressed(pGUIHEADER Object, pPOINT pt)
+{
+    pLISTVIEW List = (pLISTVIEW)Object;
+    boolean   Flinging = (LVFlingList == List);
+
+    GUI_StopListViewFling(List);
+
+    List->PenY = List->PenStartY = pt->y;
+    List->PenTicks = USC_GetCurrentTicks();
+    List->Velocity = 0;
+    List->Dragging = false;
+
+    if (!Flinging) GUI_SetListViewPressed(List, GUI_GetListViewItemFromY(List, pt->y));             // The press stopping the fling is not a click
+}
+
+static void GUI_ListViewOnMove(pGUIHEADER Object, pPOINT pt)
+{
+    pLISTVIEW List = (pLISTVIEW)Object;
+    int32_t   Ticks = USC_GetCurrentTicks();
+    int32_t   dy = pt->y - List->PenY, dt = Ticks - List->PenTicks;
+
+    if (!List->Dragging)
+    {
+        if (abs(pt->y - List->PenStartY) < LV_DRAGTHRESHOLD) return;
+
+        List->Dragging = true;
+        GUI_SetListViewPressed(List, -1);
+    }
+
+    GUI_ScrollListView(List, List->ScrollPos - dy);
+    if (dt > 0) List->Velocity = (List->Velocity - dy * 1000000 / dt) / 2;                          // Smoothed pen speed
+
+    List->PenY = pt->y;
+    List->PenTicks = Ticks;
+}
+
+static void GUI_ListViewOnReleased(pGUIHEADER Object, pPOINT pt)
+{
+    pLISTVIEW List = (pLISTVIEW)Object;
+    int32_t   Pressed = List->Pressed;
+
+    GUI_SetListViewPressed(List, -1);
+
+    if (List->Dragging)
+    {
+        List->Dragging = false;
+        if ((USC_GetCurrentTicks() - List->PenTicks) > LV_FLINGTIMEOUT) List->Velocity = 0;
+        if (abs(List->Velocity) >= LV_MINFLINGSPEED) GUI_StartListViewFling(List);
+    }
+    else if ((Pressed >= 0) && (pt->x >= 0) && (pt->x <= List->Head.Position.r - List->Head.Position.l) &&
+             (GUI_GetListViewItemFromY(List, pt->y) == Pressed) && (List->OnItemClick != NULL))
+        List->OnItemClick(List, Pressed);
+}
+
+pLISTVIEW GUI_CreateListView(pGUIHEADER Parent, TRECT Position, pBFC_FONT Font, int16_t ItemHeight,
+                             uint32_t ItemCount, wchar_t *(*GetItemText)(pLISTVIEW, uint32_t),
+                             uint32_t ForeColor, uint32_t BackColor, TGOFLAGS Flags)
+{
+    pLISTVIEW List;
+
+    if (!IsWindowObject(Parent) || (ItemHeight <= 0)) return NULL;
+
+    List = malloc(sizeof(TLISTVIEW));
+    if (List != NULL)
+    {
+        memset(List, 0x00, sizeof(TLISTVIEW));
+
+        List->Head.Type = GO_LISTVIEW;
+        List->Head.Position = GDI_LocalToGlobalRct(&Position, &Parent->Position.lt);
+        List->Head.Parent = Parent;
+        List->Head.Enabled = (Flags & GF_ENABLED) != 0;
+        List->Head.Visible = (Flags & GF_VISIBLE) != 0;
+        List->Head.OnPressed = GUI_ListViewOnPressed;
+        List->Head.OnMove = GUI_ListViewOnMove;
+        List->Head.OnReleased = GUI_ListViewOnReleased;
+
+        List->ForeColor = ForeColor;
+        List->BackColor = BackColor;
+        List->SelColor = clGray;
+        List->Font = Font;
+        List->ItemCount = ItemCount;
+        List->ItemHeight = ItemHeight;
+        List->Pressed = -1;
+        List->GetItemText = GetItemText;
+
+        if (!GUI_UpdateListViewRows(List) ||
+                !GUI_InsertObject(&List->Head))
+        {
+            GUI_FreeListViewData(List);
+            free(List);
+            List = NULL;
+        }
+        else GUI_Invalidate(&List->Head, NULL);
+    }
+    return List;
+}
+
+/* Called by GUI_DestroyObject, the object itself is freed there. */
+void GUI_FreeListViewData(pLISTVIEW List)
+{
+    uint32_t i;
+
+    if (List == NULL) return;
+
+    GUI_StopListViewFling(List);
+    for(i = 0; i < List->RowCount; i++) GDI_DestroyText(List->Rows[i].Text);
+    free(List->Rows);
+    List->Rows = NULL;
+    List->RowCount = 0;
+}
+
+void GUI_SetListViewItemCount(pLISTVIEW List, uint32_t ItemCount)
+{
+    if (List == NULL) return;
+
+    GUI_StopListViewFling(List);
+    GUI_SetListViewPressed(List, -1);
+    GUI_ResetListViewRows(List);
+
+    List->ItemCount = ItemCount;
+    List->ScrollPos = min(List->ScrollPos, GUI_GetListViewMaxScroll(List));
+    GUI_Invalidate(&List->Head, NULL);
+}
+
+/* The content of the item is changed, its text is requested again. */
+void GUI_InvalidateListViewItem(pLISTVIEW List, uint32_t Index)
+{
+    if ((List == NULL) || (List->RowCount == 0)) return;
+
+    if (List->Rows[Index % List->RowCount].Index == (int32_t)Index)
+        List->Rows[Index % List->RowCount].Index = -1;
+    GUI_InvalidateListViewRect(List, Index);
+}
+
+/*
+ScrollPos is clamped to the list, returns false if it was out of it.
+The pixels of the view are moved by the next paint pass together with
+the other scrolls before it, only the uncovered rows are painted.
+*/
+boolean GUI_ScrollListView(pLISTVIEW List, int32_t ScrollPos)
+{
+    int32_t MaxScroll, dy;
+    boolean Result = true;
+
+    if (List == NULL) return false;
+
+    MaxScroll = GUI_GetListViewMaxScroll(List);
+    if ((ScrollPos < 0) || (ScrollPos > MaxScroll))
+    {
+        ScrollPos = (ScrollPos < 0) ? 0 : MaxScroll;
+        Result = false;
+    }
+
+    dy = List->ScrollPos - ScrollPos;
+    if (dy != 0)
+    {
+        TREGION ValidRgn = {0};
+
+        List->ScrollPos = ScrollPos;
+        if ((abs(dy) < GUI_GetListViewHeight(List)) && GUI_GetObjectValidRegion(&List->Head, &ValidRgn))
+            GUI_MoveObjectPixels(&List->Head, &ValidRgn, Point(0, dy));
+        else GUI_Invalidate(&List->Head, NULL);
+        GDI_FreeRegion(&ValidRgn);
+    }
+    return Result;
+}
+
+void GUI_StopListViewFling(pLISTVIEW List)
+{
+    if ((List == NULL) || (LVFlingList != List)) return;
+
+    LRT_Stop(LVFlingTimer);
+    LVFlingList = NULL;
+    List->Velocity = 0;
+}
+
+void GUI_DrawListView(pGUIHEADER Object, pRECT Clip)
+{
+    pLISTVIEW List = (pLISTVIEW)Object;
+    TVLINDEX  Layer;
+    int32_t   i, Last;
+
+    if ((Object == NULL) || (Object->Type != GO_LISTVIEW) || (Clip == NULL)) return;
+
+    Layer = GUI_GetListViewLayer(List);
+    GUI_UpdateListViewRows(List);                                                                   // The list may be resized
+
+    i = (List->ScrollPos + Clip->t - Object->Position.t) / List->ItemHeight;
+    Last = (List->ScrollPos + Clip->b - Object->Position.t) / List->ItemHeight;
+    for(; i <= Last; i++)
+    {
+        TRECT    ItemRect = GUI_GetListViewItemRect(List, i);
+        TRECT    tmpRect = ItemRect;
+        uint32_t BackColor = (i == List->Pressed) ? List->SelColor : List->BackColor;
+        pTEXT    Text;
+
+        if (!GDI_ANDRectangles(&tmpRect, Clip)) continue;
+
+        if (i >= (int32_t)List->ItemCount) GDI_FillRectangle(Layer, tmpRect, List->BackColor);
+        else if (List->OnDrawItem != NULL) List->OnDrawItem(List, i, &ItemRect, &tmpRect);
+        else if (((Text = GUI_GetListViewRowText(List, i)) == NULL) ||
+                 !GDI_DrawText565(Layer, Text, &ItemRect, &tmpRect, List->ForeColor, BackColor,
+                                  LV_TEXTMARGIN, 0, NULL))
+            GDI_FillRectangle(Layer, tmpRect, BackColor);
+    }
+}
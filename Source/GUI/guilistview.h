@@ -0,0 +1,75 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUILISTVIEW_H_
+#define _GUILISTVIEW_H_
+
+#define LV_TEXTMARGIN       4                                                                       // Left margin of the item text
+#define LV_DRAGTHRESHOLD    8                                                                       // Shorter pen travel is a click, not a drag
+#define LV_FLINGINTERVAL    20                                                                      // Fling step in ms
+#define LV_FLINGFRICTION    16                                                                      // Velocity loses 1/16 every step
+#define LV_MINFLINGSPEED    60                                                                      // Pixels per second, slower lists stop
+#define LV_FLINGTIMEOUT     100000                                                                  // The pen resting longer (in us) cancels the fling
+
+typedef struct tag_LISTROW
+{
+    int32_t Index;                                                                                  // -1 - the row is free
+    pTEXT   Text;
+} TLISTROW, *pLISTROW;
+
+/*
+Only the rows in view exist: the item Index is kept in the row (Index % RowCount),
+so a row is reused by the item scrolled in and the memory does not depend on
+the number of items. The item text is requested by GetItemText when it comes in view.
+*/
+typedef struct tag_LISTVIEW *pLISTVIEW;
+typedef struct tag_LISTVIEW
+{
+    TGUIHEADER Head;
+    uint32_t   ForeColor;
+    uint32_t   BackColor;
+    uint32_t   SelColor;                                                                            // Background of the pressed item
+    pBFC_FONT  Font;
+    uint32_t   ItemCount;
+    int16_t    ItemHeight;
+    int32_t    ScrollPos;                                                                           // Pixels between the top of the first item and the top of the view
+    int32_t    Pressed;                                                                             // Index of the pressed item, -1 - none
+    uint32_t   RowCount;
+    pLISTROW   Rows;
+    int32_t    Velocity;                                                                            // Pixels per second, positive - towards the end of the list
+    int32_t    FlingRest;                                                                           // Fraction of the fling step in 1/1000 of pixel
+    int16_t    PenY;
+    int16_t    PenStartY;
+    int32_t    PenTicks;
+    boolean    Dragging;
+    wchar_t    *(*GetItemText)(pLISTVIEW, uint32_t);
+    void       (*OnDrawItem)(pLISTVIEW, uint32_t, pRECT, pRECT);                                    // Owner drawn items: Index, ItemRect, Clip
+    void       (*OnItemClick)(pLISTVIEW, uint32_t);
+} TLISTVIEW;
+
+extern pLISTVIEW GUI_CreateListView(pGUIHEADER Parent, TRECT Position, pBFC_FONT Font, int16_t ItemHeight,
+                                    uint32_t ItemCount, wchar_t *(*GetItemText)(pLISTVIEW, uint32_t),
+                                    uint32_t ForeColor, uint32_t BackColor, TGOFLAGS Flags);
+extern void GUI_FreeListViewData(pLISTVIEW List);
+extern void GUI_SetListViewItemCount(pLISTVIEW List, uint32_t ItemCount);
+extern void GUI_InvalidateListViewItem(pLISTVIEW List, uint32_t Index);
+extern boolean GUI_ScrollListView(pLISTVIEW List, int32_t ScrollPos);
+extern void GUI_StopListViewFling(pLISTVIEW List);
+extern void GUI_DrawListView(pGUIHEADER Object, pRECT Clip);
+
+#endif /* _GUILISTVIEW_H_ */
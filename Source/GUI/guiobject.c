@@ -21,6 +21,8 @@
 #include "systemconfig.h"
 #include "guiobject.h"
 
+static pDLITEM GUINormalTop[LCDIF_NUMLAYERS];                                                       // Last top level window which is not topmost
+
 static void GUI_DrawDefaultWindow(pGUIHEADER Object, pRECT Clip)
 {
     pWIN  Win = (pWIN)Object;
@@ -108,6 +110,11 @@ boolean GUI_GetObjectPosition(pGUIHEADER Object, pRECT Position)
     return true;
 }
 
+/*
+A moved object keeps its pixels: they are copied in the frame buffer (or the whole layer
+is moved) by the next paint pass, only the newly exposed areas are painted.
+A resized object is repainted.
+*/
 void GUI_SetObjectPosition(pGUIHEADER Object, pRECT Position)
 {
     TRECT NewPosition;
@@ -118,25 +125,177 @@ void GUI_SetObjectPosition(pGUIHEADER Object, pRECT Position)
                   GDI_LocalToGlobalRct(Position, &Object->Parent->Position.lt);
     if (memcmp(&Object->Position, &NewPosition, sizeof(TRECT)) != 0)
     {
-        TPOINT dXY = GDI_GlobalToLocalPt(&NewPosition.lt, &Object->Position.lt);
-        pDLIST UpdateRects = GDI_SUBRectangles(&Object->Position, &NewPosition);
+        TPOINT   dXY = GDI_GlobalToLocalPt(&NewPosition.lt, &Object->Position.lt);
+        TREGION  UpdateRgn = {0}, ValidRgn = {0};
+        boolean  Moved = ((NewPosition.r - NewPosition.l) == (Object->Position.r - Object->Position.l)) &&
+                         ((NewPosition.b - NewPosition.t) == (Object->Position.b - Object->Position.t));
+        boolean  LayerMoved = Moved && IsWindowObject(Object) && GUI_MoveWindowLayer((pWIN)Object, dXY);
+        uint32_t Count;
+        pRECT    Rects;
+
+        if (!LayerMoved)
+        {
+            Moved = Moved && GUI_GetObjectValidRegion(Object, &ValidRgn);
+            GDI_SetRegionRect(&UpdateRgn, &Object->Position);                                       // Uncovered part of the old position
+            GDI_SUBRectFromRegion(&UpdateRgn, &NewPosition);
+        }
 
         Object->Position = NewPosition;
 
         if (IsWindowObject(Object))
+        {
             GUI_UpdateChildPositions(Object, &dXY);
-        GUI_Invalidate(Object, NULL);
+            if (Object->Parent == NULL) GUI_GridUpdateWindow((pWIN)Object);
+        }
+        if (LayerMoved) return;
+
+        if (Moved) GUI_MoveObjectPixels(Object, &ValidRgn, dXY);
+        else GUI_Expose(Object, NULL);
+        GDI_FreeRegion(&ValidRgn);
+
+        Rects = GDI_GetRegionRects(&UpdateRgn, &Count);
+        while(Count--)
+        {
+            if (Object->Parent != NULL) GUI_Expose(Object->Parent, Rects++);
+            else GUI_InvalidateLayer(((pWIN)Object)->Layer, Rects++);
+        }
+        GDI_FreeRegion(&UpdateRgn);
+    }
+}
+
+/*
+The objects of a list go from the bottom to the top, the topmost windows lie above
+all the other objects. NormalTop is the last item below the topmost windows, so an
+object is put to either end of its part of the list without scanning the list.
+*/
+static pDLIST GUI_GetObjectList(pGUIHEADER Object, pDLITEM **NormalTop)
+{
+    if (Object->Parent != NULL)
+    {
+        *NormalTop = &((pWIN)Object->Parent)->NormalTop;
+        return &((pWIN)Object->Parent)->ChildObjects;
+    }
+    if (!IsWindowObject(Object) || (((pWIN)Object)->Layer >= LCDIF_NUMLAYERS)) return NULL;
+
+    *NormalTop = &GUINormalTop[((pWIN)Object)->Layer];
+    return GUIWinZOrder[((pWIN)Object)->Layer];
+}
+
+static boolean GUI_IsTopmostObject(pGUIHEADER Object)
+{
+    return IsWindowObject(Object) && ((pWIN)Object)->Topmost;
+}
+
+/* Puts the object on the top of the list, but below the topmost windows if it is not topmost itself. */
+boolean GUI_InsertObject(pGUIHEADER Object)
+{
+    pDLIST  ObjectsList;
+    pDLITEM *NormalTop, After;
+
+    if ((Object == NULL) || ((ObjectsList = GUI_GetObjectList(Object, &NormalTop)) == NULL)) return false;
+
+    After = (GUI_IsTopmostObject(Object)) ? DL_GetLastItem(ObjectsList) : *NormalTop;
+    Object->ListItem = (After != NULL) ? DL_InsertItemAfter(ObjectsList, After, Object) :
+                       DL_AddItemAtIndex(ObjectsList, 0, Object);
+    if (Object->ListItem == NULL) return false;
+
+    if (!GUI_IsTopmostObject(Object)) *NormalTop = Object->ListItem;
+
+    return true;
+}
+
+void GUI_RemoveObject(pGUIHEADER Object)
+{
+    pDLIST  ObjectsList;
+    pDLITEM *NormalTop;
+
+    if ((Object == NULL) || (Object->ListItem == NULL) ||
+            ((ObjectsList = GUI_GetObjectList(Object, &NormalTop)) == NULL)) return;
+
+    if (*NormalTop == Object->ListItem) *NormalTop = DL_GetPrevItem(Object->ListItem);
+    DL_DeleteItem(ObjectsList, Object->ListItem);
+    Object->ListItem = NULL;
+}
+
+/* Moves the object to the top or to the bottom of its part of the list. */
+static boolean GUI_MoveObjectInList(pGUIHEADER Object, boolean ToTop)
+{
+    pDLIST  ObjectsList;
+    pDLITEM *NormalTop, Item, After;
+
+    if ((Object == NULL) || ((Item = Object->ListItem) == NULL) ||
+            ((ObjectsList = GUI_GetObjectList(Object, &NormalTop)) == NULL)) return false;
+
+    if (*NormalTop == Item) *NormalTop = DL_GetPrevItem(Item);
+
+    if (GUI_IsTopmostObject(Object)) After = (ToTop) ? DL_GetLastItem(ObjectsList) : *NormalTop;
+    else After = (ToTop) ? *NormalTop : NULL;
+    if (After != Item) DL_MoveItemAfter(ObjectsList, Item, After);
+
+    if (!GUI_IsTopmostObject(Object) && (ToTop || (*NormalTop == NULL))) *NormalTop = Item;
+
+    if ((Object->Parent == NULL) && IsWindowObject(Object))
+    {
+        pWIN Win = (pWIN)Object;
+
+        Win->ZKey = (ToTop) ? GUI_GridNewZKey(Win->Topmost) : GUI_GridNewBottomZKey(Win->Topmost);
+    }
+    return true;
+}
+
+/* Only the parts of the layer where the visible part of the object changes are repainted. */
+static boolean GUI_ChangeZOrder(pGUIHEADER Object, boolean ToTop)
+{
+    TREGION  OldRgn = {0}, NewRgn = {0}, ChangedRgn = {0};
+    TVLINDEX Layer = LCDIF_NUMLAYERS;
+    boolean  Result;
+
+    if (!GUI_GetObjectVisibleRegion(Object, &OldRgn, &Layer)) GDI_FreeRegion(&OldRgn);
 
-        while (DL_GetItemsCount(UpdateRects))
+    Result = GUI_MoveObjectInList(Object, ToTop);
+    if (Result)
+    {
+        if (!GUI_GetObjectVisibleRegion(Object, &NewRgn, &Layer)) GDI_FreeRegion(&NewRgn);
+
+        if (Layer < LCDIF_NUMLAYERS)
         {
-            pDLITEM tmpDLItem = DL_GetFirstItem(UpdateRects);
+            uint32_t Count;
+            pRECT    Rects;
 
-            if (tmpDLItem->Data != NULL)
-                GUI_Invalidate(Object->Parent, (pRECT)tmpDLItem->Data);
-            DL_DeleteFirstItem(UpdateRects);
+            GDI_SUBRegions(&ChangedRgn, &NewRgn, &OldRgn);                                          // Uncovered parts of the object
+            GDI_SUBRegions(&OldRgn, &OldRgn, &NewRgn);                                              // Parts covered by the others now
+            GDI_ADDRegions(&ChangedRgn, &ChangedRgn, &OldRgn);
+
+            Rects = GDI_GetRegionRects(&ChangedRgn, &Count);
+            while(Count--) GUI_InvalidateLayer(Layer, Rects++);
         }
-        DL_Delete(UpdateRects, false);
     }
+    GDI_FreeRegion(&OldRgn);
+    GDI_FreeRegion(&NewRgn);
+    GDI_FreeRegion(&ChangedRgn);
+
+    return Result;
+}
+
+/* Raises the object above its siblings, the topmost windows stay above the others. */
+boolean GUI_BringToFront(pGUIHEADER Object)
+{
+    return GUI_ChangeZOrder(Object, true);
+}
+
+boolean GUI_SendToBack(pGUIHEADER Object)
+{
+    return GUI_ChangeZOrder(Object, false);
+}
+
+/* The window is put on the top of its new part of the list. */
+boolean GUI_SetTopmost(pWIN Win, boolean Topmost)
+{
+    if (!IsWindowObject((pGUIHEADER)Win)) return false;
+    if (Win->Topmost == Topmost) return true;
+
+    Win->Topmost = Topmost;
+    return GUI_ChangeZOrder((pGUIHEADER)Win, true);
 }
 
 pWIN GUI_CreateWindow(pGUIHEADER Parent, TRECT Position, boolean (*Handler)(pEVENT, pWIN),
@@ -151,13 +310,11 @@ pWIN GUI_CreateWindow(pGUIHEADER Parent, TRECT Position, boolean (*Handler)(pEVE
     Win = malloc(sizeof(TWIN));
     if (Win != NULL)
     {
-        pDLIST ObjectsList;
-
         Layer = (Parent != NULL) ? ((pWIN)Parent)->Layer : Layer;
-        ObjectsList = (Parent == NULL) ? GUIWinZOrder[Layer] : &((pWIN)Parent)->ChildObjects;
 
         memset(Win, 0x00, sizeof(TWIN));
 
+        Win->Head.Type = GO_WINDOW;
         Win->Head.Position = (Parent != NULL) ?
                              GDI_LocalToGlobalRct(&Position, &Parent->Position.lt) : Position;
         Win->Head.Parent = Parent;
@@ -169,29 +326,19 @@ pWIN GUI_CreateWindow(pGUIHEADER Parent, TRECT Position, boolean (*Handler)(pEVE
         Win->Layer = Layer;
         Win->ForeColor = ForeColor;
         Win->EventHandler = Handler;
+        Win->GridCells = Rect(0, 0, -1, -1);
 
-        if (Win->Topmost) Result = DL_AddItem(ObjectsList, Win) != NULL;                            // Put the handle directly to the top of the list
-        else                                                                                        // Looking for top window among non-topmost objects
+        Result = GUI_InsertObject((pGUIHEADER)Win);
+        if (Result && (Flags & GF_RETAINED)) Result = GUI_SetWindowRetained(Win, true);
+        if (Result && (Parent == NULL))
         {
-            pDLITEM tmpItem = DL_GetLastItem(ObjectsList);
-
-            while(tmpItem != NULL)
-            {
-                pGUIHEADER tmpObject = tmpItem->Data;
-
-                if ((tmpObject != NULL) &&
-                        (!IsWindowObject(tmpObject) || !((pWIN)tmpObject)->Topmost))
-                {
-                    Result = DL_InsertItemAfter(ObjectsList, tmpItem, Win) != NULL;
-                    break;
-                }
-                tmpItem = DL_GetPrevItem(tmpItem);
-            }
-            if (tmpItem == NULL) Result = DL_AddItemAtIndex(ObjectsList, 0, Win) != NULL;
+            Win->ZKey = GUI_GridNewZKey(Win->Topmost);
+            Result = GUI_GridInsertWindow(Win);
         }
-        if (Result) Win->Head.Type = GO_WINDOW;
-        else
+        if (!Result)
         {
+            GUI_RemoveObject((pGUIHEADER)Win);
+            GUI_FreeBackStore(Win);
             free(Win);
             Win = NULL;
         }
@@ -199,6 +346,39 @@ pWIN GUI_CreateWindow(pGUIHEADER Parent, TRECT Position, boolean (*Handler)(pEVE
     return Win;
 }
 
+/* Destroys the object together with its child objects and frees the occupied area. */
+void GUI_DestroyObject(pGUIHEADER Object)
+{
+    TRECT Position;
+
+    if (Object == NULL) return;
+
+    if (IsWindowObject(Object))
+    {
+        pDLITEM tmpItem;
+
+        Object->Visible = false;                                                                    // Do not draw children while they are destroyed
+        while((tmpItem = DL_GetLastItem(&((pWIN)Object)->ChildObjects)) != NULL)
+        {
+            if (tmpItem->Data != NULL) GUI_DestroyObject((pGUIHEADER)tmpItem->Data);
+            else DL_DeleteItem(&((pWIN)Object)->ChildObjects, tmpItem);
+        }
+        if (Object->Parent == NULL) GUI_GridRemoveWindow((pWIN)Object);
+        GUI_FreeBackStore((pWIN)Object);
+    }
+    else if (Object->Type == GO_LISTVIEW) GUI_FreeListViewData((pLISTVIEW)Object);
+    else GUI_FreeWidgetData(Object);
+
+    GUI_RemoveObject(Object);
+
+    GUI_ReleasePenCapture(Object);
+    GUI_StopObjectAnimations(Object);
+    Position = Object->Position;
+    if (Object->Parent != NULL) GUI_Expose(Object->Parent, &Position);
+    else if (IsWindowObject(Object)) GUI_InvalidateLayer(((pWIN)Object)->Layer, &Position);         // Redraw the windows lying below
+    free(Object);
+}
+
 boolean IsWindowObject(pGUIHEADER Object)
 {
     return ((Object != NULL) && (Object->Type == GO_WINDOW));
@@ -228,23 +408,14 @@ pWIN GUI_GetTopWindow(TVLINDEX Layer, boolean Topmost)
         tmpWIN = (tmpItem == NULL) ? NULL : (pWIN)tmpItem->Data;
         Res = ((tmpWIN == NULL) || !tmpWIN->Topmost) ? NULL : tmpWIN;
     }
-    else
-    {
-        tmpItem = DL_GetLastItem(GUIWinZOrder[Layer]);
-        while(tmpItem != NULL)
-        {
-            tmpWIN = (pWIN)tmpItem->Data;
-            if ((tmpWIN != NULL) && !tmpWIN->Topmost)
-            {
-                Res = tmpWIN;
-                break;
-            }
-            tmpItem = DL_GetPrevItem(tmpItem);
-        }
-    }
+    else if (GUINormalTop[Layer] != NULL) Res = (pWIN)GUINormalTop[Layer]->Data;
     return Res;
 }
 
+/*
+Returns the top level window under the screen point pt. The layers above hide it
+if they hold windows or are opaque, the blended layers without windows do not.
+*/
 pWIN GUI_GetWindowFromPoint(pPOINT pt, int32_t *ZIndex)
 {
     int32_t i;
@@ -254,51 +425,67 @@ pWIN GUI_GetWindowFromPoint(pPOINT pt, int32_t *ZIndex)
     {
         for(i = LCDIF_NUMLAYERS - 1; i >= 0; i--)
         {
-            pDLITEM tmpItem;
-            int32_t ItemIndex;
+            pLCONTEXT lc = &LCDScreen.VLayer[i];
+            TPOINT    LayerPt;
 
-            tmpItem = DL_GetLastItem(GUIWinZOrder[i]);
-            ItemIndex = DL_GetItemsCount(GUIWinZOrder[i]) - 1;
-            while(tmpItem != NULL)
+            if (!lc->Enabled) continue;
+
+            LayerPt = GDI_LocalToGlobalPt(pt, &LCDScreen.ScreenOffset);                             // Screen to layer coordinates
+            LayerPt = GDI_GlobalToLocalPt(&LayerPt, &lc->LayerOffset);
+
+            Win = GUI_GridWindowFromPoint(i, LayerPt.x, LayerPt.y);
+            if (Win != NULL)
             {
-                Win = tmpItem->Data;
-                if ((Win != NULL) && Win->Head.Visible && IsPointInRect(pt->x, pt->y, &Win->Head.Position))
-                {
-                    if (ZIndex != NULL) *ZIndex = ItemIndex;
-                    return Win;
-                }
-                ItemIndex--;
-                tmpItem = DL_GetPrevItem(tmpItem);
+                if (ZIndex != NULL) *ZIndex = GUI_GetWindowZIndex(Win);
+                return Win;
             }
-            if (LCDScreen.VLayer[i].Enabled && IsPointInRect(pt->x, pt->y, &LCDScreen.VLayer[i].LayerRgn))
-                break;
+            if (IsPointInRect(LayerPt.x, LayerPt.y, &lc->LayerRgn) &&
+                    (LCDIF_IsLayerOpaque(i) || DL_GetItemsCount(GUIWinZOrder[i]))) break;
         }
     }
     if (ZIndex != NULL) *ZIndex = -1;
     return NULL;
 }
 
+/* Draws the object itself, the screen is not updated. */
+boolean GUI_PaintObject(pGUIHEADER Object, pRECT Clip)
+{
+    if ((Object == NULL) || (Clip == NULL)) return false;
+
+    if (Object->OnPaint != NULL) Object->OnPaint(Object, Clip);
+    else switch(Object->Type)
+        {
+        case GO_WINDOW:
+            GUI_DrawDefaultWindow(Object, Clip);
+            break;
+        case GO_LISTVIEW:
+            GUI_DrawListView(Object, Clip);
+            break;
+        case GO_LABEL:
+        case GO_BUTTON:
+        case GO_IMAGE:
+        case GO_PROGRESS:
+            GUI_DrawWidget(Object, Clip);
+            break;
+        default:
+            return false;
+        }
+    return true;
+}
+
 void GUI_DrawObjectDefault(pGUIHEADER Object, pRECT Clip)
 {
     if ((Object != NULL) && (Clip != NULL))
     {
-        TRECT    UpdateRect;
         TVLINDEX Layer;
 
-        if (Object->OnPaint != NULL) Object->OnPaint(Object, Clip);
-        else switch(Object->Type)
-            {
-            case GO_WINDOW:
-                GUI_DrawDefaultWindow(Object, Clip);
-                break;
-            default:
-                return;
-            }
+        if (!IsWindowObject(Object) || !GUI_DrawFromBackStore((pWIN)Object, Clip))
+        {
+            if (!GUI_PaintObject(Object, Clip)) return;
+        }
 
         Layer = (Object->Parent != NULL) ?
                 ((pWIN)Object->Parent)->Layer : ((pWIN)Object)->Layer;
-        UpdateRect = GDI_LocalToGlobalRct(Clip, &LCDScreen.VLayer[Layer].LayerOffset);
-        UpdateRect = GDI_GlobalToLocalRct(&UpdateRect, &LCDScreen.ScreenOffset);
-        LCDIF_UpdateRectangle(UpdateRect);
+        GUI_UpdateScreenRect(Layer, Clip);
     }
 }
@@ -23,6 +23,11 @@ typedef enum tag_GOTYPE
 {
     GO_UNKNOWN,
     GO_WINDOW,
+    GO_LISTVIEW,
+    GO_LABEL,
+    GO_BUTTON,
+    GO_IMAGE,
+    GO_PROGRESS,
 
     GO_NUMTYPES
 } TGOTYPE;
@@ -32,7 +37,8 @@ typedef enum tag_GOFLAGS
     GF_ENABLED  = (1 << 0),
     GF_VISIBLE  = (1 << 1),
     GF_TOPMOST  = (1 << 2),
-    GF_FRAMED   = (1 << 3)
+    GF_FRAMED   = (1 << 3),
+    GF_RETAINED = (1 << 4)                                                                          // Keep the rendered window in a backing store
 } TGOFLAGS;
 
 typedef struct tag_GUIHEADER *pGUIHEADER;
@@ -44,6 +50,7 @@ typedef struct tag_GUIHEADER
     boolean    Enabled;
     boolean    Visible;
     int32_t    Tag;
+    pDLITEM    ListItem;                                                                            // Item of the object in the list of its parent or layer
     void       (*OnPressed)(pGUIHEADER, pPOINT);
     void       (*OnReleased)(pGUIHEADER, pPOINT);
     void       (*OnMove)(pGUIHEADER, pPOINT);
@@ -51,6 +58,7 @@ typedef struct tag_GUIHEADER
     void       (*OnPaint)(pGUIHEADER, pRECT);
 } TGUIHEADER, *pGUIHEADER;
 
+typedef struct tag_BACKSTORE *pBACKSTORE;
 typedef struct tag_WIN *pWIN;
 typedef struct tag_WIN
 {
@@ -60,15 +68,30 @@ typedef struct tag_WIN
     uint32_t    Layer;
     uint32_t    ForeColor;
     TDLIST      ChildObjects;
+    pDLITEM     NormalTop;                                                                          // Last child object which is not topmost
     boolean     (*EventHandler)(pEVENT, pWIN);
+    uint32_t    ZKey;                                                                               // Z-order key of a top level window
+    TRECT       GridCells;                                                                          // Cells of the window grid occupied by the window
+    uint32_t    GridMark;
+    pBACKSTORE  BackStore;                                                                          // NULL - the window is not retained
 } TWIN, *pWIN;
 
 extern TRECT GUI_CalculateClientArea(pGUIHEADER Object);
 extern boolean GUI_GetObjectPosition(pGUIHEADER Object, pRECT Position);
 extern void GUI_SetObjectPosition(pGUIHEADER Object, pRECT Position);
 extern boolean IsWindowObject(pGUIHEADER Object);
+extern boolean GUI_InsertObject(pGUIHEADER Object);
+extern void GUI_RemoveObject(pGUIHEADER Object);
 extern pWIN GUI_CreateWindow(pGUIHEADER Parent, TRECT Position, boolean (*Handler)(pEVENT, pWIN),
                              uint8_t Layer, uint32_t ForeColor, TGOFLAGS Flags);
+extern void GUI_DestroyObject(pGUIHEADER Object);
+extern int32_t GUI_GetWindowZIndex(pWIN Win);
+extern pWIN GUI_GetTopWindow(TVLINDEX Layer, boolean Topmost);
+extern boolean GUI_BringToFront(pGUIHEADER Object);
+extern boolean GUI_SendToBack(pGUIHEADER Object);
+extern boolean GUI_SetTopmost(pWIN Win, boolean Topmost);
+extern pWIN GUI_GetWindowFromPoint(pPOINT pt, int32_t *ZIndex);
+extern boolean GUI_PaintObject(pGUIHEADER Object, pRECT Clip);
 extern void GUI_DrawObjectDefault(pGUIHEADER Object, pRECT Clip);
 
 #endif /* _GUIOBJECT_H_ */
@@ -0,0 +1,240 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guioverlay.h"
+
+
+/*
+The overlay is drawn straight into its own alpha blended layer, it is not a window
+and does not go through the paint pass, so it does not change the timings it shows.
+The overlay is updated only with the painted frames, an idle screen stays idle.
+The text lines are redrawn only when their strings change and not more often than
+OVL_TEXTINTERVAL. The graph is swept like an oscilloscope: every frame draws one
+column and clears the next one, so a frame costs two columns of pixels.
+The columns show the frame time, the lower part is the paint time.
+*/
+
+#define OVL_NUMLINES    3
+#define OVL_LINESIZE    32
+
+static boolean  OvlShown;
+static boolean  OvlRelease;                                                                         // The layer is freed by the next frame
+static pTEXT    OvlLines[OVL_NUMLINES];
+static wchar_t  OvlStrings[OVL_NUMLINES][OVL_LINESIZE];
+static TRECT    OvlLineRect[OVL_NUMLINES];
+static TRECT    OvlGraphRect;
+static int16_t  OvlGraphX;                                                                          // Column of the next sample
+static int32_t  OvlTextTicks;
+static uint32_t OvlDropped;                                                                         // Dropped frames before the overlay was shown
+
+static wchar_t *GUI_OvlPutStr(wchar_t *Dst, const char *Src)
+{
+    while(*Src) *Dst++ = *Src++;
+    return Dst;
+}
+
+static wchar_t *GUI_OvlPutUInt(wchar_t *Dst, uint32_t Value)
+{
+    wchar_t  Digits[10];
+    uint32_t n = 0;
+
+    do
+    {
+        Digits[n++] = '0' + Value % 10;
+        Value /= 10;
+    }
+    while(Value);
+    while(n) *Dst++ = Digits[--n];
+
+    return Dst;
+}
+
+/* Microseconds as milliseconds with one decimal. */
+static wchar_t *GUI_OvlPutTime(wchar_t *Dst, uint32_t Time)
+{
+    Time = (Time + 50) / 100;
+    Dst = GUI_OvlPutUInt(Dst, Time / 10);
+    *Dst++ = '.';
+    *Dst++ = '0' + Time % 10;
+
+    return Dst;
+}
+
+static void GUI_OvlSetLine(uint32_t Line, wchar_t *String)
+{
+    if (!memcmp(OvlStrings[Line], String, sizeof(OvlStrings[Line]))) return;                        // Not changed
+    memcpy(OvlStrings[Line], String, sizeof(OvlStrings[Line]));
+
+    if (GDI_SetTextString(OvlLines[Line], String) &&
+            GDI_DrawText565(OVL_LAYER, OvlLines[Line], &OvlLineRect[Line], &OvlLineRect[Line],
+                            OVL_TEXTCOLOR, OVL_BACKCOLOR, 0, 0, NULL))
+        GUI_UpdateScreenRect(OVL_LAYER, &OvlLineRect[Line]);
+}
+
+/* Redraws the text lines changed since the last call. */
+static void GUI_OvlUpdateText(void)
+{
+    TFRAMESTAT FrameStat;
+    TLCDIFSTAT LCDStat;
+    wchar_t    Line[OVL_LINESIZE], *p;
+    uint32_t   Peak;
+    int32_t    Ticks = USC_GetCurrentTicks();
+
+    if ((uint32_t)(Ticks - OvlTextTicks) < OVL_TEXTINTERVAL) return;
+    OvlTextTicks = Ticks;
+
+    GUI_GetFrameStat(&FrameStat, false);
+    LCDIF_GetTransferStat(&LCDStat, false);
+    EM_GetQueueDepth(&Peak, true);
+
+    memset(Line, 0x00, sizeof(Line));
+    p = GUI_OvlPutStr(Line, "Frm ");
+    p = GUI_OvlPutTime(p, FrameStat.FrameTime);
+    p = GUI_OvlPutStr(p, " Pnt ");
+    GUI_OvlPutTime(p, FrameStat.PaintTime);
+    GUI_OvlSetLine(0, Line);
+
+    memset(Line, 0x00, sizeof(Line));
+    p = GUI_OvlPutStr(Line, "LCD ");
+    p = GUI_OvlPutTime(p, LCDStat.LastTime);
+    p = GUI_OvlPutStr(p, " Evt ");
+    GUI_OvlPutUInt(p, Peak);
+    GUI_OvlSetLine(1, Line);
+
+    memset(Line, 0x00, sizeof(Line));
+    p = GUI_OvlPutStr(Line, "Heap ");
+    p = GUI_OvlPutUInt(p, GetTotalUsedMemory() >> 10);
+    p = GUI_OvlPutStr(p, "K Drop ");
+    GUI_OvlPutUInt(p, FrameStat.Dropped - OvlDropped);
+    GUI_OvlSetLine(2, Line);
+}
+
+boolean GUI_ShowDebugOverlay(pBFC_FONT Font, TPOINT Position)
+{
+    TFRAMESTAT FrameStat;
+    int16_t    Height, y;
+    uint32_t   i;
+
+    if (Font == NULL) return false;
+
+    GUI_HideDebugOverlay();
+
+    Height = OVL_NUMLINES * Font->FontHeight + OVL_GRAPHHEIGHT + 3 * OVL_MARGIN;
+    Position = GDI_LocalToGlobalPt(&Position, &LCDScreen.ScreenOffset);
+    OvlRelease = false;
+    if (!LCDIF_SetupLayer(OVL_LAYER, Position, OVL_WIDTH, Height, CF_RGB565, OVL_ALPHA)) return false;
+
+    for(i = 0; i < OVL_NUMLINES; i++)
+    {
+        OvlLines[i] = GDI_CreateText(Font, NULL, AH_LEFT | AV_TOP, TXF_ELLIPSIS, OVL_WIDTH - 2 * OVL_MARGIN, 1);
+        if (OvlLines[i] == NULL)
+        {
+            GUI_HideDebugOverlay();
+            LCDIF_SetupLayer(OVL_LAYER, Point(0, 0), 0, 0, CF_RGB565, 0xFF);
+            return false;
+        }
+    }
+    memset(OvlStrings, 0x00, sizeof(OvlStrings));
+    GDI_FillRectangle(OVL_LAYER, LCDScreen.VLayer[OVL_LAYER].LayerRgn, OVL_BACKCOLOR);
+
+    y = OVL_MARGIN;
+    for(i = 0; i < OVL_NUMLINES; i++, y += Font->FontHeight)
+        OvlLineRect[i] = Rect(OVL_MARGIN, y, OVL_WIDTH - OVL_MARGIN - 1, y + Font->FontHeight - 1);
+    OvlGraphRect = Rect(OVL_MARGIN, y + OVL_MARGIN, OVL_WIDTH - OVL_MARGIN - 1, Height - OVL_MARGIN - 1);
+    OvlGraphX = OvlGraphRect.l;
+
+    GUI_GetFrameStat(&FrameStat, false);
+    OvlDropped = FrameStat.Dropped;
+    EM_GetQueueDepth(NULL, true);
+
+    OvlShown = true;
+    OvlTextTicks = USC_GetCurrentTicks() - OVL_TEXTINTERVAL;
+    GUI_OvlUpdateText();
+    GUI_SetLayerEnabled(OVL_LAYER, true);
+
+    return true;
+}
+
+void GUI_HideDebugOverlay(void)
+{
+    uint32_t i;
+
+    for(i = 0; i < OVL_NUMLINES; i++)
+    {
+        GDI_DestroyText(OvlLines[i]);
+        OvlLines[i] = NULL;
+    }
+    if (OvlShown)
+    {
+        OvlShown = false;
+        OvlRelease = true;                                                                          // The layer is sent until the next frame
+        GUI_SetLayerEnabled(OVL_LAYER, false);
+    }
+}
+
+boolean GUI_IsDebugOverlayShown(void)
+{
+    return OvlShown;
+}
+
+/*
+Called by the frame scheduler before the frame is painted, so the overlay is sent
+to the screen together with the frame. Stat holds the time of the current frame
+and the paint time of the previous one. The hidden overlay is freed here,
+the previous frame is sent and this one is painted with the layer disabled.
+*/
+void GUI_UpdateDebugOverlay(pFRAMESTAT Stat, uint32_t FrameInterval)
+{
+    TRECT   Column;
+    int16_t Frame, Paint, Target;
+
+    if (OvlRelease)
+    {
+        OvlRelease = false;
+        LCDIF_SetupLayer(OVL_LAYER, Point(0, 0), 0, 0, CF_RGB565, 0xFF);                            // Free the frame buffer
+    }
+    if (!OvlShown || (Stat == NULL)) return;
+
+    Frame  = min(Stat->FrameTime / OVL_GRAPHSCALE, OVL_GRAPHHEIGHT);
+    Paint  = min(Stat->PaintTime / OVL_GRAPHSCALE, (uint32_t)Frame);
+    Target = FrameInterval / OVL_GRAPHSCALE;
+
+    Column = Rect(OvlGraphX, OvlGraphRect.t, OvlGraphX, OvlGraphRect.b);
+    GDI_FillRectangle(OVL_LAYER, Column, OVL_BACKCOLOR);
+    if (Frame > Paint)
+        GDI_FillRectangle(OVL_LAYER, Rect(OvlGraphX, OvlGraphRect.b - Frame + 1, OvlGraphX, OvlGraphRect.b - Paint),
+                          (FrameInterval && (Stat->FrameTime > FrameInterval + FrameInterval / 4)) ?
+                          OVL_LATECOLOR : OVL_FRAMECOLOR);
+    if (Paint)
+        GDI_FillRectangle(OVL_LAYER, Rect(OvlGraphX, OvlGraphRect.b - Paint + 1, OvlGraphX, OvlGraphRect.b),
+                          OVL_PAINTCOLOR);
+    if (Target && (Target < OVL_GRAPHHEIGHT))
+        GDI_SetPixel(OVL_LAYER, Point(OvlGraphX, OvlGraphRect.b - Target), OVL_TARGETCOLOR);
+
+    if (++OvlGraphX > OvlGraphRect.r) OvlGraphX = OvlGraphRect.l;
+    GUI_UpdateScreenRect(OVL_LAYER, &Column);
+
+    Column = Rect(OvlGraphX, OvlGraphRect.t, OvlGraphX, OvlGraphRect.b);                            // The sweep gap
+    GDI_FillRectangle(OVL_LAYER, Column, OVL_BACKCOLOR);
+    GUI_UpdateScreenRect(OVL_LAYER, &Column);
+
+    GUI_OvlUpdateText();
+}
@@ -0,0 +1,42 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUIOVERLAY_H_
+#define _GUIOVERLAY_H_
+
+#define OVL_LAYER           LCDIF_LAYER3                                                            // Must not be used by the windows
+#define OVL_ALPHA           0xC0
+#define OVL_WIDTH           120
+#define OVL_MARGIN          2
+#define OVL_GRAPHHEIGHT     32
+#define OVL_GRAPHSCALE      2000                                                                    // us of the frame time per pixel
+#define OVL_TEXTINTERVAL    250000                                                                  // us between the text updates
+
+#define OVL_TEXTCOLOR       clWhite
+#define OVL_BACKCOLOR       clBlack
+#define OVL_PAINTCOLOR      clYellow
+#define OVL_FRAMECOLOR      clLime
+#define OVL_LATECOLOR       clRed
+#define OVL_TARGETCOLOR     clSilver
+
+extern boolean GUI_ShowDebugOverlay(pBFC_FONT Font, TPOINT Position);
+extern void GUI_HideDebugOverlay(void);
+extern boolean GUI_IsDebugOverlayShown(void);
+extern void GUI_UpdateDebugOverlay(pFRAMESTAT Stat, uint32_t FrameInterval);
+
+#endif /* _GUIOVERLAY_H_ */
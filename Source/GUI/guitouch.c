@@ -0,0 +1,173 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guitouch.h"
+
+/*
+Pen events come in screen coordinates. The press goes to the topmost object
+under the pen or, if it has no pen handlers, to the nearest parent having them.
+This object captures the pen: the moves and the release are sent to it only,
+even when the pen leaves the object. The release inside the object is followed
+by OnClick. Handlers get the point relative to the top left corner of the object.
+*/
+
+static pGUIHEADER GUIPenCapture[GUI_NUMPENS];
+
+static TPOINT GUI_ScreenToLayerPt(TVLINDEX Layer, pPOINT pt)
+{
+    TPOINT Res = GDI_LocalToGlobalPt(pt, &LCDScreen.ScreenOffset);
+
+    return GDI_GlobalToLocalPt(&Res, &LCDScreen.VLayer[Layer].LayerOffset);
+}
+
+static TPOINT GUI_ScreenToObjectPt(pGUIHEADER Object, pPOINT pt)
+{
+    pGUIHEADER Root = Object;
+    TPOINT     Res = *pt;
+
+    while(Root->Parent != NULL) Root = Root->Parent;
+    if (IsWindowObject(Root) && (((pWIN)Root)->Layer < LCDIF_NUMLAYERS))
+        Res = GUI_ScreenToLayerPt(((pWIN)Root)->Layer, pt);
+
+    Res.x -= Object->Position.l;
+    Res.y -= Object->Position.t;
+
+    return Res;
+}
+
+static boolean GUI_IsObjectActive(pGUIHEADER Object)
+{
+    for(; Object != NULL; Object = Object->Parent)
+        if (!Object->Enabled || !Object->Visible) return false;
+
+    return true;
+}
+
+static boolean GUI_HasPenHandlers(pGUIHEADER Object)
+{
+    return (Object->OnPressed != NULL) || (Object->OnReleased != NULL) ||
+           (Object->OnMove != NULL) || (Object->OnClick != NULL);
+}
+
+static pGUIHEADER GUI_GetChildFromPoint(pWIN Win, int16_t x, int16_t y)
+{
+    TRECT   ClientArea = GUI_CalculateClientArea((pGUIHEADER)Win);
+    pDLITEM tmpItem;
+
+    if (!IsPointInRect(x, y, &ClientArea)) return (pGUIHEADER)Win;                                  // Children are clipped by the client area
+
+    tmpItem = DL_GetLastItem(&Win->ChildObjects);
+    while(tmpItem != NULL)
+    {
+        pGUIHEADER tmpObject = (pGUIHEADER)tmpItem->Data;
+
+        if ((tmpObject != NULL) && tmpObject->Visible && IsPointInRect(x, y, &tmpObject->Position))
+        {
+            return (IsWindowObject(tmpObject)) ?
+                   GUI_GetChildFromPoint((pWIN)tmpObject, x, y) : tmpObject;
+        }
+        tmpItem = DL_GetPrevItem(tmpItem);
+    }
+    return (pGUIHEADER)Win;
+}
+
+/* Returns the topmost visible object under the screen point pt. */
+pGUIHEADER GUI_GetObjectFromPoint(pPOINT pt)
+{
+    pWIN   Win = GUI_GetWindowFromPoint(pt, NULL);
+    TPOINT LayerPt;
+
+    if (Win == NULL) return NULL;
+
+    LayerPt = GUI_ScreenToLayerPt(Win->Layer, pt);
+    return GUI_GetChildFromPoint(Win, LayerPt.x, LayerPt.y);
+}
+
+pGUIHEADER GUI_GetPenCapture(uint32_t PenIndex)
+{
+    return (PenIndex < GUI_NUMPENS) ? GUIPenCapture[PenIndex] : NULL;
+}
+
+/* Called when the object is destroyed, so that no more events are sent to it. */
+void GUI_ReleasePenCapture(pGUIHEADER Object)
+{
+    uint32_t i;
+
+    for(i = 0; i < GUI_NUMPENS; i++)
+        if (GUIPenCapture[i] == Object) GUIPenCapture[i] = NULL;
+}
+
+void GUI_OnPenPressed(pPENEVENT Event)
+{
+    pGUIHEADER Object;
+    TPOINT     LocalPt;
+
+    if ((Event == NULL) || (Event->PenIndex >= GUI_NUMPENS)) return;
+
+    GUIPenCapture[Event->PenIndex] = NULL;                                                          // The release of the previous press was lost
+
+    Object = GUI_GetObjectFromPoint(&Event->PXY);
+    if ((Object == NULL) || !GUI_IsObjectActive(Object)) return;                                    // Disabled objects swallow the pen
+
+    while((Object != NULL) && !GUI_HasPenHandlers(Object)) Object = Object->Parent;
+    if (Object == NULL) return;
+
+    GUIPenCapture[Event->PenIndex] = Object;
+    if (Object->OnPressed != NULL)
+    {
+        LocalPt = GUI_ScreenToObjectPt(Object, &Event->PXY);
+        Object->OnPressed(Object, &LocalPt);
+    }
+}
+
+void GUI_OnPenReleased(pPENEVENT Event)
+{
+    pGUIHEADER Object;
+    TPOINT     LocalPt;
+    TRECT      Bounds;
+
+    if ((Event == NULL) || ((Object = GUI_GetPenCapture(Event->PenIndex)) == NULL)) return;
+
+    LocalPt = GUI_ScreenToObjectPt(Object, &Event->PXY);
+    if (Object->OnReleased != NULL)
+    {
+        Object->OnReleased(Object, &LocalPt);
+        if (GUIPenCapture[Event->PenIndex] != Object) return;                                       // The object was destroyed by the handler
+    }
+    GUIPenCapture[Event->PenIndex] = NULL;
+
+    Bounds = Rect(0, 0, Object->Position.r - Object->Position.l, Object->Position.b - Object->Position.t);
+    if ((Object->OnClick != NULL) && GUI_IsObjectActive(Object) &&
+            IsPointInRect(LocalPt.x, LocalPt.y, &Bounds))
+        Object->OnClick(Object, &LocalPt);
+}
+
+void GUI_OnPenMoved(pPENEVENT Event)
+{
+    pGUIHEADER Object;
+    TPOINT     LocalPt;
+
+    if ((Event == NULL) || ((Object = GUI_GetPenCapture(Event->PenIndex)) == NULL) ||
+            (Object->OnMove == NULL)) return;
+
+    LocalPt = GUI_ScreenToObjectPt(Object, &Event->PXY);
+    Object->OnMove(Object, &LocalPt);
+}
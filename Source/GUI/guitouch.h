@@ -0,0 +1,31 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUITOUCH_H_
+#define _GUITOUCH_H_
+
+#define GUI_NUMPENS     2                                                                           // Number of tracked touch points
+
+extern pGUIHEADER GUI_GetObjectFromPoint(pPOINT pt);
+extern pGUIHEADER GUI_GetPenCapture(uint32_t PenIndex);
+extern void GUI_ReleasePenCapture(pGUIHEADER Object);
+extern void GUI_OnPenPressed(pPENEVENT Event);
+extern void GUI_OnPenReleased(pPENEVENT Event);
+extern void GUI_OnPenMoved(pPENEVENT Event);
+
+#endif /* _GUITOUCH_H_ */
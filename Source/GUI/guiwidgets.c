@@ -0,0 +1,552 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "guiwidgets.h"
+
+static const int16_t SinTable[91] =                                                                 // sin(0..90 degrees) in Q14
+{
+    0,     286,   572,   857,   1143,  1428,  1713,  1997,  2280,  2563,
+    2845,  3126,  3406,  3686,  3964,  4240,  4516,  4790,  5063,  5334,
+    5604,  5872,  6138,  6402,  6664,  6924,  7182,  7438,  7692,  7943,
+    8192,  8438,  8682,  8923,  9162,  9397,  9630,  9860,  10087, 10311,
+    10531, 10749, 10963, 11174, 11381, 11585, 11786, 11982, 12176, 12365,
+    12551, 12733, 12911, 13085, 13255, 13421, 13583, 13741, 13894, 14044,
+    14189, 14330, 14466, 14598, 14726, 14849, 14968, 15082, 15191, 15296,
+    15396, 15491, 15582, 15668, 15749, 15826, 15897, 15964, 16026, 16083,
+    16135, 16182, 16225, 16262, 16294, 16322, 16344, 16362, 16374, 16382,
+    16384
+};
+
+static int32_t GUI_Sin(int32_t Deg)
+{
+    Deg %= 360;
+    if (Deg < 0) Deg += 360;
+
+    if (Deg <= 90) return SinTable[Deg];
+    if (Deg <= 180) return SinTable[180 - Deg];
+    if (Deg <= 270) return -SinTable[Deg - 180];
+    return -SinTable[360 - Deg];
+}
+
+static int32_t GUI_Cos(int32_t Deg)
+{
+    return GUI_Sin(Deg + 90);
+}
+
+static TVLINDEX GUI_GetWidgetLayer(pGUIHEADER Object)
+{
+    return ((pWIN)Object->Parent)->Layer;
+}
+
+static pGUIHEADER GUI_AllocWidget(pGUIHEADER Parent, TRECT Position, TGOTYPE Type, uint32_t Size, TGOFLAGS Flags)
+{
+    pGUIHEADER Object;
+
+    if (!IsWindowObject(Parent)) return NULL;
+
+    Object = malloc(Size);
+    if (Object != NULL)
+    {
+        memset(Object, 0x00, Size);
+
+        Object->Type = Type;
+        Object->Position = GDI_LocalToGlobalRct(&Position, &Parent->Position.lt);
+        Object->Parent = Parent;
+        Object->Enabled = (Flags & GF_ENABLED) != 0;
+        Object->Visible = (Flags & GF_VISIBLE) != 0;
+    }
+    return Object;
+}
+
+static pGUIHEADER GUI_AddWidget(pGUIHEADER Object)
+{
+    if (Object == NULL) return NULL;
+
+    if (!GUI_InsertObject(Object))
+    {
+        GUI_FreeWidgetData(Object);
+        free(Object);
+        return NULL;
+    }
+    GUI_Invalidate(Object, NULL);
+
+    return Object;
+}
+
+static void GUI_InvalidateWidgetRect(pGUIHEADER Object, TRECT Rct)
+{
+    if ((Rct.l <= Rct.r) && (Rct.t <= Rct.b) && GDI_ANDRectangles(&Rct, &Object->Position))
+        GUI_Invalidate(Object, &Rct);
+}
+
+/* The rectangle of sx * sy pixels aligned in Client. */
+static TRECT GUI_AlignRect(pRECT Client, int16_t sx, int16_t sy, TTEXTALIGN Align)
+{
+    TRECT Res;
+
+    switch (Align & AH_MASK)
+    {
+    case AH_RIGHT:
+        Res.l = Client->r - sx + 1;
+        break;
+    case AH_CENTER:
+        Res.l = Client->l + (Client->r - Client->l - sx + 1) / 2;
+        break;
+    default:
+        Res.l = Client->l;
+        break;
+    }
+    switch (Align & AV_MASK)
+    {
+    case AV_BOTTOM:
+        Res.t = Client->b - sy + 1;
+        break;
+    case AV_CENTER:
+        Res.t = Client->t + (Client->b - Client->t - sy + 1) / 2;
+        break;
+    default:
+        Res.t = Client->t;
+        break;
+    }
+    Res.r = Res.l + sx - 1;
+    Res.b = Res.t + sy - 1;
+
+    return Res;
+}
+
+/* Lines of the text are aligned the same way as in GDI_DrawText565(), so they lie inside this rectangle. */
+static TRECT GUI_GetTextRect(pTEXT Text, pRECT Client)
+{
+    if (!GDI_UpdateTextLayout(Text)) return Rect(0, 0, -1, -1);
+
+    return GUI_AlignRect(Client, Text->Extent.sx, Text->Extent.sy, Text->Align);
+}
+
+/* Only the old and the new text are painted, the rest of the client keeps the background. */
+static void GUI_ChangeWidgetText(pGUIHEADER Object, pTEXT Text, pRECT Client, wchar_t *String)
+{
+    TRECT   OldRect = GUI_GetTextRect(Text, Client);
+    boolean Valid = Text->LayoutValid;
+
+    if (!GDI_SetTextString(Text, String) || (Valid && Text->LayoutValid)) return;                   // The same string
+
+    if (Valid)
+    {
+        GUI_InvalidateWidgetRect(Object, OldRect);
+        GUI_InvalidateWidgetRect(Object, GUI_GetTextRect(Text, Client));
+    }
+    else GUI_InvalidateWidgetRect(Object, *Client);
+}
+
+static TRECT GUI_GetButtonClient(pBUTTON Button)
+{
+    TRECT Client = Button->Head.Position;
+
+    if (Button->Framed)
+    {
+        Client.l++;
+        Client.t++;
+        Client.r--;
+        Client.b--;
+    }
+    return Client;
+}
+
+static void GUI_ButtonOnPressed(pGUIHEADER Object, pPOINT pt)
+{
+    GUI_SetButtonPressed((pBUTTON)Object, true);
+}
+
+static void GUI_ButtonOnMove(pGUIHEADER Object, pPOINT pt)
+{
+    TRECT Bounds = Rect(0, 0, Object->Position.r - Object->Position.l, Object->Position.b - Object->Position.t);
+
+    GUI_SetButtonPressed((pBUTTON)Object, IsPointInRect(pt->x, pt->y, &Bounds));                    // Pops up while the pen is outside
+}
+
+static void GUI_ButtonOnReleased(pGUIHEADER Object, pPOINT pt)
+{
+    GUI_SetButtonPressed((pBUTTON)Object, false);
+}
+
+static TRECT GUI_GetImageRect(pIMAGE Image)
+{
+    if ((Image->Bitmap == NULL) || (Image->Bitmap->Data == NULL)) return Rect(0, 0, -1, -1);
+
+    return GUI_AlignRect(&Image->Head.Position, Image->Bitmap->Width, Image->Bitmap->Height, Image->Align);
+}
+
+static int32_t GUI_GetProgressAngle(pPROGRESS Progress, uint16_t Value)
+{
+    return (Progress->Range) ? (uint32_t)Value * 360 / Progress->Range : 0;
+}
+
+static int16_t GUI_GetProgressBarEdge(pPROGRESS Progress, uint16_t Value)
+{
+    int32_t Width = Progress->Head.Position.r - Progress->Head.Position.l + 1;
+
+    return Progress->Head.Position.l + ((Progress->Range) ? Width * Value / Progress->Range : 0);
+}
+
+/*
+The arc is calculated in doubled coordinates, so the center lies on the pixel grid
+for any size of the object: D is the outer diameter, d is the inner one.
+*/
+static void GUI_GetArcDiameters(pPROGRESS Progress, int32_t *D, int32_t *d)
+{
+    pRECT Pos = &Progress->Head.Position;
+
+    *D = min(Pos->r - Pos->l + 1, Pos->b - Pos->t + 1);
+    *d = max(*D - 2 * Progress->Thickness, 0);
+}
+
+/* True if the clockwise angle of (dx, dy) from the top is less than Angle, (ux, uy) - direction of Angle. */
+static boolean GUI_IsArcFilled(int32_t dx, int32_t dy, int32_t Angle, int32_t ux, int32_t uy)
+{
+    boolean RightHalf = (dx > 0) || ((dx == 0) && (dy < 0));
+    boolean Before = dx * uy - dy * ux >= 0;
+
+    if (Angle >= 360) return true;
+    if (Angle <= 0) return false;
+
+    return (Angle <= 180) ? RightHalf && Before : RightHalf || Before;
+}
+
+/* Pixels of the same color are filled by runs. */
+static void GUI_DrawProgressArc(pPROGRESS Progress, TVLINDEX Layer, pRECT Clip)
+{
+    pRECT   Pos = &Progress->Head.Position;
+    int32_t Angle = GUI_GetProgressAngle(Progress, Progress->Value);
+    int32_t ux = GUI_Sin(Angle), uy = -GUI_Cos(Angle);
+    int32_t D, d, x, y;
+
+    GUI_GetArcDiameters(Progress, &D, &d);
+    for(y = Clip->t; y <= Clip->b; y++)
+    {
+        int32_t  dy = 2 * y - (Pos->t + Pos->b);
+        int32_t  RunStart = Clip->l;
+        uint32_t RunColor = 0;
+
+        for(x = Clip->l; x <= Clip->r; x++)
+        {
+            int32_t  dx = 2 * x - (Pos->l + Pos->r);
+            int32_t  d2 = dx * dx + dy * dy;
+            uint32_t Color;
+
+            if ((d2 > D * D) || (d2 <= d * d)) Color = Progress->BackColor;
+            else Color = GUI_IsArcFilled(dx, dy, Angle, ux, uy) ? Progress->ForeColor : Progress->TrackColor;
+
+            if ((x > RunStart) && (Color != RunColor))
+            {
+                GDI_FillRectangle(Layer, Rect(RunStart, y, x - 1, y), RunColor);
+                RunStart = x;
+            }
+            RunColor = Color;
+        }
+        GDI_FillRectangle(Layer, Rect(RunStart, y, Clip->r, y), RunColor);
+    }
+}
+
+/* Bounding rectangle of the ring sector between the angles a < b. */
+static TRECT GUI_GetArcSectorRect(pPROGRESS Progress, int32_t a, int32_t b)
+{
+    static const int16_t Extremes[] = {90, 180, 270};
+    pRECT   Pos = &Progress->Head.Position;
+    int32_t D, d, i;
+    int32_t Points[7][2];
+    int32_t Count = 0;
+    TRECT   Res;
+
+    GUI_GetArcDiameters(Progress, &D, &d);
+
+    Points[Count][0] = GUI_Sin(a) * D;
+    Points[Count++][1] = -GUI_Cos(a) * D;
+    Points[Count][0] = GUI_Sin(a) * d;
+    Points[Count++][1] = -GUI_Cos(a) * d;
+    Points[Count][0] = GUI_Sin(b) * D;
+    Points[Count++][1] = -GUI_Cos(b) * D;
+    Points[Count][0] = GUI_Sin(b) * d;
+    Points[Count++][1] = -GUI_Cos(b) * d;
+    for(i = 0; i < 3; i++)                                                                          // The ring is the widest on the axes
+    {
+        if ((a < Extremes[i]) && (Extremes[i] < b))
+        {
+            Points[Count][0] = GUI_Sin(Extremes[i]) * D;
+            Points[Count++][1] = -GUI_Cos(Extremes[i]) * D;
+        }
+    }
+
+    Res = Rect(Pos->r, Pos->b, Pos->l, Pos->t);
+    for(i = 0; i < Count; i++)
+    {
+        int32_t x = (Pos->l + Pos->r + (Points[i][0] >> 14)) >> 1;
+        int32_t y = (Pos->t + Pos->b + (Points[i][1] >> 14)) >> 1;
+
+        Res.l = min(Res.l, x - 1);                                                                  // One pixel for the rounding
+        Res.r = max(Res.r, x + 1);
+        Res.t = min(Res.t, y - 1);
+        Res.b = max(Res.b, y + 1);
+    }
+    return Res;
+}
+
+pLABEL GUI_CreateLabel(pGUIHEADER Parent, TRECT Position, pBFC_FONT Font, wchar_t *String,
+                       TTEXTALIGN Align, uint32_t ForeColor, uint32_t BackColor, TGOFLAGS Flags)
+{
+    pLABEL Label = (pLABEL)GUI_AllocWidget(Parent, Position, GO_LABEL, sizeof(TLABEL), Flags);
+
+    if (Label != NULL)
+    {
+        int16_t  Width = Label->Head.Position.r - Label->Head.Position.l + 1;
+        uint16_t Lines = ((Font != NULL) && (Font->FontHeight != 0)) ?
+                         (Label->Head.Position.b - Label->Head.Position.t + 1) / Font->FontHeight : 0;
+
+        Label->ForeColor = ForeColor;
+        Label->BackColor = BackColor;
+        Label->Text = GDI_CreateText(Font, String, Align, TXF_WORDWRAP | TXF_ELLIPSIS, Width, max(Lines, 1));
+        if (Label->Text == NULL)
+        {
+            free(Label);
+            return NULL;
+        }
+    }
+    return (pLABEL)GUI_AddWidget((pGUIHEADER)Label);
+}
+
+void GUI_SetLabelText(pLABEL Label, wchar_t *String)
+{
+    if ((Label == NULL) || (Label->Head.Type != GO_LABEL)) return;
+
+    GUI_ChangeWidgetText(&Label->Head, Label->Text, &Label->Head.Position, String);
+}
+
+/* The click is reported by Head.OnClick. */
+pBUTTON GUI_CreateButton(pGUIHEADER Parent, TRECT Position, pBFC_FONT Font, wchar_t *String,
+                         uint32_t ForeColor, uint32_t BackColor, TGOFLAGS Flags)
+{
+    pBUTTON Button = (pBUTTON)GUI_AllocWidget(Parent, Position, GO_BUTTON, sizeof(TBUTTON), Flags);
+
+    if (Button != NULL)
+    {
+        TRECT Client;
+
+        Button->Head.OnPressed = GUI_ButtonOnPressed;
+        Button->Head.OnMove = GUI_ButtonOnMove;
+        Button->Head.OnReleased = GUI_ButtonOnReleased;
+        Button->ForeColor = ForeColor;
+        Button->BackColor = BackColor;
+        Button->PressedColor = clGray;
+        Button->Framed = (Flags & GF_FRAMED) != 0;
+
+        Client = GUI_GetButtonClient(Button);
+        Button->Text = GDI_CreateText(Font, String, AH_CENTER | AV_CENTER, TXF_ELLIPSIS,
+                                      Client.r - Client.l + 1, 1);
+        if (Button->Text == NULL)
+        {
+            free(Button);
+            return NULL;
+        }
+    }
+    return (pBUTTON)GUI_AddWidget((pGUIHEADER)Button);
+}
+
+void GUI_SetButtonText(pBUTTON Button, wchar_t *String)
+{
+    TRECT Client;
+
+    if ((Button == NULL) || (Button->Head.Type != GO_BUTTON)) return;
+
+    Client = GUI_GetButtonClient(Button);
+    GUI_ChangeWidgetText(&Button->Head, Button->Text, &Client, String);
+}
+
+/* The background of the client is changed, the frame is not. */
+void GUI_SetButtonPressed(pBUTTON Button, boolean Pressed)
+{
+    if ((Button == NULL) || (Button->Head.Type != GO_BUTTON) || (Button->Pressed == Pressed)) return;
+
+    Button->Pressed = Pressed;
+    if (Button->PressedColor != Button->BackColor)
+        GUI_InvalidateWidgetRect(&Button->Head, GUI_GetButtonClient(Button));
+}
+
+pIMAGE GUI_CreateImage(pGUIHEADER Parent, TRECT Position, pBITMAP Bitmap, TTEXTALIGN Align,
+                       uint32_t BackColor, TGOFLAGS Flags)
+{
+    pIMAGE Image = (pIMAGE)GUI_AllocWidget(Parent, Position, GO_IMAGE, sizeof(TIMAGE), Flags);
+
+    if (Image != NULL)
+    {
+        Image->Bitmap = Bitmap;
+        Image->Align = Align;
+        Image->Mode = BM_COPY;
+        Image->BackColor = BackColor;
+    }
+    return (pIMAGE)GUI_AddWidget((pGUIHEADER)Image);
+}
+
+/* Also called when the content of the bitmap is changed. */
+void GUI_SetImageBitmap(pIMAGE Image, pBITMAP Bitmap)
+{
+    if ((Image == NULL) || (Image->Head.Type != GO_IMAGE)) return;
+
+    GUI_InvalidateWidgetRect(&Image->Head, GUI_GetImageRect(Image));
+    Image->Bitmap = Bitmap;
+    GUI_InvalidateWidgetRect(&Image->Head, GUI_GetImageRect(Image));
+}
+
+pPROGRESS GUI_CreateProgress(pGUIHEADER Parent, TRECT Position, TPROGRESSSTYLE Style, uint16_t Range,
+                             uint32_t ForeColor, uint32_t TrackColor, uint32_t BackColor, TGOFLAGS Flags)
+{
+    pPROGRESS Progress = (pPROGRESS)GUI_AllocWidget(Parent, Position, GO_PROGRESS, sizeof(TPROGRESS), Flags);
+
+    if (Progress != NULL)
+    {
+        Progress->Style = Style;
+        Progress->Range = Range;
+        Progress->ForeColor = ForeColor;
+        Progress->TrackColor = TrackColor;
+        Progress->BackColor = BackColor;
+        Progress->Thickness = max(min(Position.r - Position.l + 1, Position.b - Position.t + 1) / 8, 1);
+    }
+    return (pPROGRESS)GUI_AddWidget((pGUIHEADER)Progress);
+}
+
+/* Only the part between the old and the new value is painted. */
+void GUI_SetProgressValue(pPROGRESS Progress, uint16_t Value)
+{
+    uint16_t OldValue;
+
+    if ((Progress == NULL) || (Progress->Head.Type != GO_PROGRESS)) return;
+
+    Value = min(Value, Progress->Range);
+    if (Value == Progress->Value) return;
+
+    OldValue = Progress->Value;
+    Progress->Value = Value;
+
+    if (Progress->Style == PS_ARC)
+    {
+        int32_t a = GUI_GetProgressAngle(Progress, min(OldValue, Value));
+        int32_t b = GUI_GetProgressAngle(Progress, max(OldValue, Value));
+
+        if (a != b) GUI_InvalidateWidgetRect(&Progress->Head, GUI_GetArcSectorRect(Progress, a, b));
+    }
+    else
+    {
+        int16_t a = GUI_GetProgressBarEdge(Progress, min(OldValue, Value));
+        int16_t b = GUI_GetProgressBarEdge(Progress, max(OldValue, Value));
+
+        GUI_InvalidateWidgetRect(&Progress->Head, Rect(a, Progress->Head.Position.t, b - 1, Progress->Head.Position.b));
+    }
+}
+
+/* Called by GUI_DestroyObject, the object itself is freed there. */
+void GUI_FreeWidgetData(pGUIHEADER Object)
+{
+    if (Object == NULL) return;
+
+    switch(Object->Type)
+    {
+    case GO_LABEL:
+        GDI_DestroyText(((pLABEL)Object)->Text);
+        ((pLABEL)Object)->Text = NULL;
+        break;
+    case GO_BUTTON:
+        GDI_DestroyText(((pBUTTON)Object)->Text);
+        ((pBUTTON)Object)->Text = NULL;
+        break;
+    default:
+        break;
+    }
+}
+
+void GUI_DrawWidget(pGUIHEADER Object, pRECT Clip)
+{
+    TVLINDEX Layer;
+
+    if ((Object == NULL) || (Clip == NULL) || (Object->Parent == NULL)) return;
+
+    Layer = GUI_GetWidgetLayer(Object);
+    switch(Object->Type)
+    {
+    case GO_LABEL:
+    {
+        pLABEL Label = (pLABEL)Object;
+
+        if (!GDI_DrawText565(Layer, Label->Text, &Object->Position, Clip, Label->ForeColor, Label->BackColor, 0, 0, NULL))
+            GDI_FillRectangle(Layer, *Clip, Label->BackColor);
+    }
+    break;
+    case GO_BUTTON:
+    {
+        pBUTTON  Button = (pBUTTON)Object;
+        TRECT    Client = GUI_GetButtonClient(Button), tmpRect;
+        uint32_t BackColor = (Button->Pressed) ? Button->PressedColor : Button->BackColor;
+
+        if (Button->Framed) GDI_DrawFrame(Layer, &Object->Position, Clip, Button->ForeColor);
+
+        tmpRect = Client;
+        if (GDI_ANDRectangles(&tmpRect, Clip) &&
+                !GDI_DrawText565(Layer, Button->Text, &Client, &tmpRect, Button->ForeColor, BackColor, 0, 0, NULL))
+            GDI_FillRectangle(Layer, tmpRect, BackColor);
+    }
+    break;
+    case GO_IMAGE:
+    {
+        pIMAGE   Image = (pIMAGE)Object;
+        TRECT    ImageRect = GUI_GetImageRect(Image);
+        TREGION  BackRgn = {0};
+        uint32_t Count;
+        pRECT    Rects;
+
+        GDI_SetRegionRect(&BackRgn, Clip);
+        if ((Image->Mode == BM_COPY) && (ImageRect.l <= ImageRect.r))
+            GDI_SUBRectFromRegion(&BackRgn, &ImageRect);                                            // Covered by the bitmap
+
+        Rects = GDI_GetRegionRects(&BackRgn, &Count);
+        while(Count--) GDI_FillRectangle(Layer, *Rects++, Image->BackColor);
+        GDI_FreeRegion(&BackRgn);
+
+        if (ImageRect.l <= ImageRect.r)
+            GDI_BitBlt(Layer, ImageRect.lt, Image->Bitmap, NULL, Clip, Image->Mode, Image->Key);
+    }
+    break;
+    case GO_PROGRESS:
+    {
+        pPROGRESS Progress = (pPROGRESS)Object;
+
+        if (Progress->Style == PS_ARC) GUI_DrawProgressArc(Progress, Layer, Clip);
+        else
+        {
+            int16_t Edge = GUI_GetProgressBarEdge(Progress, Progress->Value);
+            TRECT   tmpRect = Rect(Object->Position.l, Object->Position.t, Edge - 1, Object->Position.b);
+
+            if (GDI_ANDRectangles(&tmpRect, Clip)) GDI_FillRectangle(Layer, tmpRect, Progress->ForeColor);
+            tmpRect = Rect(Edge, Object->Position.t, Object->Position.r, Object->Position.b);
+            if (GDI_ANDRectangles(&tmpRect, Clip)) GDI_FillRectangle(Layer, tmpRect, Progress->TrackColor);
+        }
+    }
+    break;
+    default:
+        break;
+    }
+}
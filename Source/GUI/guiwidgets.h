@@ -0,0 +1,90 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _GUIWIDGETS_H_
+#define _GUIWIDGETS_H_
+
+/*
+Widgets are child objects of windows. Their background colors must be opaque:
+a widget paints every pixel of its position and a state change invalidates
+only the pixels which are changed.
+*/
+typedef struct tag_LABEL
+{
+    TGUIHEADER Head;
+    pTEXT      Text;
+    uint32_t   ForeColor;
+    uint32_t   BackColor;
+} TLABEL, *pLABEL;
+
+typedef struct tag_BUTTON
+{
+    TGUIHEADER Head;
+    pTEXT      Text;
+    uint32_t   ForeColor;                                                                           // Text and frame color
+    uint32_t   BackColor;
+    uint32_t   PressedColor;                                                                        // Background of the pressed button
+    boolean    Framed;
+    boolean    Pressed;
+} TBUTTON, *pBUTTON;
+
+typedef struct tag_IMAGE
+{
+    TGUIHEADER Head;
+    pBITMAP    Bitmap;                                                                              // Not copied, must exist while it is shown
+    TTEXTALIGN Align;
+    TBLTMODE   Mode;
+    uint32_t   Key;
+    uint32_t   BackColor;
+} TIMAGE, *pIMAGE;
+
+typedef enum tag_PROGRESSSTYLE
+{
+    PS_BAR,                                                                                         // Filled from the left to the right
+    PS_ARC                                                                                          // Ring filled clockwise from the top
+} TPROGRESSSTYLE;
+
+typedef struct tag_PROGRESS
+{
+    TGUIHEADER     Head;
+    TPROGRESSSTYLE Style;
+    uint32_t       ForeColor;                                                                       // Filled part
+    uint32_t       TrackColor;                                                                      // Not filled part
+    uint32_t       BackColor;                                                                       // Outside of the ring
+    uint16_t       Range;
+    uint16_t       Value;
+    int16_t        Thickness;                                                                       // Width of the ring
+} TPROGRESS, *pPROGRESS;
+
+extern pLABEL GUI_CreateLabel(pGUIHEADER Parent, TRECT Position, pBFC_FONT Font, wchar_t *String,
+                              TTEXTALIGN Align, uint32_t ForeColor, uint32_t BackColor, TGOFLAGS Flags);
+extern void GUI_SetLabelText(pLABEL Label, wchar_t *String);
+extern pBUTTON GUI_CreateButton(pGUIHEADER Parent, TRECT Position, pBFC_FONT Font, wchar_t *String,
+                                uint32_t ForeColor, uint32_t BackColor, TGOFLAGS Flags);
+extern void GUI_SetButtonText(pBUTTON Button, wchar_t *String);
+extern void GUI_SetButtonPressed(pBUTTON Button, boolean Pressed);
+extern pIMAGE GUI_CreateImage(pGUIHEADER Parent, TRECT Position, pBITMAP Bitmap, TTEXTALIGN Align,
+                              uint32_t BackColor, TGOFLAGS Flags);
+extern void GUI_SetImageBitmap(pIMAGE Image, pBITMAP Bitmap);
+extern pPROGRESS GUI_CreateProgress(pGUIHEADER Parent, TRECT Position, TPROGRESSSTYLE Style, uint16_t Range,
+                                    uint32_t ForeColor, uint32_t TrackColor, uint32_t BackColor, TGOFLAGS Flags);
+extern void GUI_SetProgressValue(pPROGRESS Progress, uint16_t Value);
+extern void GUI_FreeWidgetData(pGUIHEADER Object);
+extern void GUI_DrawWidget(pGUIHEADER Object, pRECT Clip);
+
+#endif /* _GUIWIDGETS_H_ */
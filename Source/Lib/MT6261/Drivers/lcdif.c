@@ -30,7 +30,30 @@ pLAYER LCDIF_LAYER[LCDIF_NUMLAYERS] = {(volatile pLAYER) &LCDIF_LAYER0BASE,
                                       };
 
 TSCREEN LCDScreen;
-pDLIST  LCDIFQueue;
+
+/*
+The update commands are kept in the ring of descriptors, so neither the
+producer nor the ISR touch the heap. Only the producer advances the tail and
+only the consumer (ISR or LCDIF_RestartQueue with interrupts disabled) advances
+the head, both indexes run free and are wrapped by the mask.
+The descriptor is released when its transfer is complete, so the head is also
+the count of the sent updates. The fence of an update is the head value after
+it is sent, a fence is reached when the head passes it.
+The completion handlers are kept in their own ring in the submit order, so the
+ISR only advances the head. LCDIF_ProcessCompletions() calls them from the main
+loop once their fences are reached. A submit with a handler is refused while this
+ring is full, so no completion is lost.
+*/
+static TLCDCMD           LCDIFQueue[MAX_LCDQUEUE_SIZE];
+static volatile uint32_t LCDIFQueueHead;                                                            // Descriptor being sent or the next to send
+static volatile uint32_t LCDIFQueueTail;                                                            // Next free descriptor
+static TLCDDONE          LCDIFDone[MAX_LCDQUEUE_SIZE];
+static uint32_t          LCDIFDoneHead;                                                             // Next handler to call
+static uint32_t          LCDIFDoneTail;                                                             // Next free completion
+
+static volatile TLCDIFSTAT LCDIFStat;
+static volatile int32_t    LCDIFStartTicks;                                                         // Start of the current run of the queue
+static uint32_t            LCDIFPendingLayers;                                                      // Layers waiting for LCDIF_CommitLayers()
 
 void LCDIF_WriteCommand(uint8_t Cmd)
 {
@@ -63,86 +86,114 @@ boolean LCDIF_IsQueueRunning(void)
     return (LCDIF_START & LCDIF_RUN) != 0;
 }
 
-void LCDIF_DeleteCommandFromQueue(void)
+boolean LCDIF_GetCommandFromQueue(void)
 {
-    pDLITEM tmpItem = DL_GetFirstItem(LCDIFQueue);
+    pLCDCMD CMD;
+
+    if (LCDIFQueueHead == LCDIFQueueTail) return false;
+
+    CMD = &LCDIFQueue[LCDIFQueueHead & (MAX_LCDQUEUE_SIZE - 1)];
+    LCDIF_WROIOFS   = LCDIF_WROIOFX(CMD->UpdateRect.l + LCDScreen.ScreenOffset.x) |
+                      LCDIF_WROIOFY(CMD->UpdateRect.t + LCDScreen.ScreenOffset.y);
+    LCDIF_WROISIZE  = LCDIF_WROICOL(CMD->UpdateRect.r - CMD->UpdateRect.l + 1) |
+                      LCDIF_WROIROW(CMD->UpdateRect.b - CMD->UpdateRect.t + 1);
 
-    if (tmpItem != NULL)
+    if (CMD->CMDCount)
     {
-        if (((pLCDCMD)tmpItem->Data)->Commands != NULL)
-            free(((pLCDCMD)tmpItem->Data)->Commands);
-        free(tmpItem->Data);
-        DL_DeleteFirstItem(LCDIFQueue);
+        uint32_t i;
+
+        for(i = 0; i < CMD->CMDCount; i++) LCDIF_COMD(i) = CMD->Commands[i];
+        LCDIF_WROICON &= ~LCDIF_COMMAND_MASK;
+        LCDIF_WROICON |= LCDIF_COMMAND(CMD->CMDCount - 1) | LCDIF_ENC;
     }
+    else LCDIF_WROICON &= ~LCDIF_ENC;
+
+    return true;
 }
 
-boolean LCDIF_GetCommandFromQueue(void)
+void LCDIF_RestartQueue(void)
 {
-    pDLITEM tmpItem;
+    uint32_t flags = DisableInterrupts();
 
-    while((tmpItem = DL_GetFirstItem(LCDIFQueue)) != NULL)
+    if (!LCDIF_IsQueueRunning() && LCDIF_GetCommandFromQueue())
     {
-        pLCDCMD CMD = tmpItem->Data;
-
-        if (CMD != NULL)
-        {
-            LCDIF_WROIOFS   = LCDIF_WROIOFX(CMD->UpdateRect.l + LCDScreen.ScreenOffset.x) |
-                              LCDIF_WROIOFY(CMD->UpdateRect.t + LCDScreen.ScreenOffset.y);
-            LCDIF_WROISIZE  = LCDIF_WROICOL(CMD->UpdateRect.r - CMD->UpdateRect.l + 1) |
-                              LCDIF_WROIROW(CMD->UpdateRect.b - CMD->UpdateRect.t + 1);
-
-            if (CMD->CMDCount)
-            {
-                uint32_t i;
+        LCDIFStartTicks = USC_GetCurrentTicks();
+        LCDIF_StartLCDTransfer();
+    }
 
-                for(i = 0; i < CMD->CMDCount; i++) LCDIF_COMD(i) = CMD->Commands[i];
-                LCDIF_WROICON &= ~LCDIF_COMMAND_MASK;
-                LCDIF_WROICON |= LCDIF_COMMAND(CMD->CMDCount - 1) | LCDIF_ENC;
-            }
-            else LCDIF_WROICON &= ~LCDIF_ENC;
+    RestoreInterrupts(flags);
+}
 
-            LCDIF_DeleteCommandFromQueue();
-            return true;
-        }
-        LCDIF_DeleteCommandFromQueue();
+/*
+Returns the free descriptor at the tail of the queue or NULL if the queue is full and Wait is false.
+The queue is restarted while waiting, so a stopped transfer can not hang the producer.
+*/
+static pLCDCMD LCDIF_GetFreeCommand(boolean Wait)
+{
+    if (LCDIFQueueTail - LCDIFQueueHead >= MAX_LCDQUEUE_SIZE)
+    {
+        LCDIFStat.Stalls++;
+        if (!Wait) return NULL;
+        while(LCDIFQueueTail - LCDIFQueueHead >= MAX_LCDQUEUE_SIZE) LCDIF_RestartQueue();
     }
-    return false;
+    return &LCDIFQueue[LCDIFQueueTail & (MAX_LCDQUEUE_SIZE - 1)];
 }
 
-void LCDIF_RestartQueue(void)
+/* Passes the descriptor taken by LCDIF_GetFreeCommand() to the ISR, returns its fence. */
+static uint32_t LCDIF_SubmitCommand(void)
 {
     uint32_t flags = DisableInterrupts();
+    uint32_t Fence = ++LCDIFQueueTail;
 
-    if (!LCDIF_IsQueueRunning() && LCDIF_GetCommandFromQueue()) LCDIF_StartLCDTransfer();
+    LCDIFStat.Updates++;
 
     RestoreInterrupts(flags);
+    LCDIF_RestartQueue();
+
+    return Fence;
 }
 
-boolean LCDIF_AddCommandToQueue(uint32_t *CmdArray, uint32_t CmdCount, pRECT UpdateRect)
+static TLCDQSTATUS LCDIF_QueueUpdate(TRECT Rct, void (*Handler)(uint32_t, void *), void *Object,
+                                     boolean Wait, uint32_t *Fence)
 {
-    pLCDCMD CMD;
+    pLCDCMD  CMD;
+    uint32_t CMDFence;
+
+    if (!GDI_ANDRectangles(&Rct, &LCDScreen.ScreenRgn)) return LQS_CLIPPED;
+    if ((Handler != NULL) && (LCDIFDoneTail - LCDIFDoneHead >= MAX_LCDQUEUE_SIZE)) return LQS_FULL;
+    if ((CMD = LCDIF_GetFreeCommand(Wait)) == NULL) return LQS_FULL;
 
-    if (CmdCount && (CmdArray != NULL))
+    CMD->CMDCount = LCDDRV_SetOutputWindow(&Rct, CMD->Commands, LCDIF_MAXCOMMANDS, LCDIF_DATA, LCDIF_CMD);
+    if (!CMD->CMDCount) return LQS_ERROR;
+
+    CMD->UpdateRect = Rct;
+    CMDFence = LCDIF_SubmitCommand();
+    if (Handler != NULL)
     {
-        CMD = malloc(sizeof(TLCDCMD));
-        if (CMD != NULL)
-        {
-            CMD->CMDCount = CmdCount;
-            CMD->UpdateRect = (UpdateRect != NULL) ? *UpdateRect : Rect(0, 0, 0, 0);
-            CMD->Commands = CmdArray;
+        pLCDDONE Done = &LCDIFDone[LCDIFDoneTail++ & (MAX_LCDQUEUE_SIZE - 1)];
 
-            if (DL_AddItem(LCDIFQueue, CMD) != NULL)
-            {
-                LCDIF_RestartQueue();
-                while(DL_GetItemsCount(LCDIFQueue) >= MAX_LCDQUEUE_SIZE);
-                return true;
-            }
-            free(CMD);
-        }
+        Done->Handler = Handler;
+        Done->Object = Object;
+        Done->Fence = CMDFence;
     }
-    if (CmdArray != NULL) free(CmdArray);
+    if (Fence != NULL) *Fence = CMDFence;
 
-    return false;
+    return LQS_QUEUED;
+}
+
+boolean LCDIF_AddCommandToQueue(const uint32_t *CmdArray, uint32_t CmdCount, pRECT UpdateRect)
+{
+    pLCDCMD CMD;
+
+    if (!CmdCount || (CmdCount > LCDIF_MAXCOMMANDS) || (CmdArray == NULL)) return false;
+
+    CMD = LCDIF_GetFreeCommand(true);
+    CMD->CMDCount = CmdCount;
+    CMD->UpdateRect = (UpdateRect != NULL) ? *UpdateRect : Rect(0, 0, 0, 0);
+    memcpy(CMD->Commands, CmdArray, CmdCount * sizeof(uint32_t));
+    LCDIF_SubmitCommand();
+
+    return true;
 }
 
 void LCDIF_ISR(void)
@@ -152,9 +203,22 @@ void LCDIF_ISR(void)
     LCDIF_START = 0;
     if ((IntID = LCDIF_INTSTA) & LCDIF_CPL)
     {
+        if (LCDIFQueueHead != LCDIFQueueTail) LCDIFQueueHead++;                                     // The sent descriptor is released
+        if (LCDIF_GetCommandFromQueue()) LCDIF_START = LCDIF_RUN;
+        else                                                                                        // The queue is empty, the transfer is complete
+        {
+            uint32_t Time = USC_GetCurrentTicks() - LCDIFStartTicks;
+
+            LCDIFStat.Transfers++;
+            LCDIFStat.LastTime = Time;
+            if (Time > LCDIFStat.MaxTime) LCDIFStat.MaxTime = Time;
+        }
+    }
+    else                                                                                            // The current update is sent again
+    {
+        DebugPrint("Unsolicited LCDIF interrupt code 0x%04X!\r\n", IntID);
         if (LCDIF_GetCommandFromQueue()) LCDIF_START = LCDIF_RUN;
     }
-    else DebugPrint("Unsolicited LCDIF interrupt code 0x%04X!\r\n", IntID);
 }
 
 boolean LCDIF_RegisterISR(void)
@@ -167,6 +231,46 @@ boolean LCDIF_UnregisterISR(void)
     return NVIC_UnregisterIRQ(IRQ_LCD_CODE);
 }
 
+/* True if all the queued updates are sent to the LCD. */
+boolean LCDIF_IsTransferComplete(void)
+{
+    return LCDIFQueueHead == LCDIFQueueTail;
+}
+
+/* The fence of the last queued update. */
+uint32_t LCDIF_GetFence(void)
+{
+    return LCDIFQueueTail;
+}
+
+/* True if the update with this fence and all the updates queued before it are sent to the LCD. */
+boolean LCDIF_IsFenceReached(uint32_t Fence)
+{
+    return (int32_t)(LCDIFQueueHead - Fence) >= 0;
+}
+
+/* Called from the main loop, calls the handlers of the sent updates in the submit order. */
+void LCDIF_ProcessCompletions(void)
+{
+    while((LCDIFDoneHead != LCDIFDoneTail) &&
+            LCDIF_IsFenceReached(LCDIFDone[LCDIFDoneHead & (MAX_LCDQUEUE_SIZE - 1)].Fence))
+    {
+        TLCDDONE Done = LCDIFDone[LCDIFDoneHead++ & (MAX_LCDQUEUE_SIZE - 1)];                       // The handler may submit again
+
+        Done.Handler(Done.Fence, Done.Object);
+    }
+}
+
+void LCDIF_GetTransferStat(pLCDIFSTAT Stat, boolean Reset)
+{
+    uint32_t flags = DisableInterrupts();
+
+    if (Stat != NULL) *Stat = LCDIFStat;
+    if (Reset) memset((void *)&LCDIFStat, 0x00, sizeof(TLCDIFSTAT));
+
+    RestoreInterrupts(flags);
+}
+
 void LCDIF_DisableInterface(void)
 {
     LCDIF_INTEN = 0;                                                                                // Disable LCDIF interrupts
@@ -177,7 +281,8 @@ void LCDIF_DisableInterface(void)
     LCDDRV_Sleep();
     PCTL_PowerDown(PD_LCD);                                                                         // Power down LCD controller
     PCTL_PowerDown(PD_SLCD);                                                                        // Power down serial interface
-    LCDIFQueue = DL_Delete(LCDIFQueue, true);
+    LCDIFQueueHead = LCDIFQueueTail;                                                                // Drop the unsent commands
+    LCDIFDoneHead = LCDIFDoneTail;                                                                  // and their handlers
 }
 
 boolean LCDIF_Initialize(void)
@@ -188,6 +293,9 @@ boolean LCDIF_Initialize(void)
     GPIO_Setup(   LCD_CE, GPMODE(LCD_CE_MODE));                                                     // Setup CS pin
     GPIO_Setup(  LCD_SCK, GPMODE(LCD_SCK_MODE));                                                    // Setup Clock pin
     GPIO_Setup(  LCD_SDA, GPMODE(LCD_SDA_MODE));                                                    // Setup Data pin
+#if defined(LCD_LPTE)
+    GPIO_Setup( LCD_LPTE, GPMODE(LCD_LPTE_MODE));                                                   // Setup Tearing effect input
+#endif
 
     LCDIF_SetClock(LCD_CLOCK_MPLL_DIV4);
     PCTL_PowerUp(PD_SLCD);                                                                          // Power up LCD serial interface
@@ -207,15 +315,9 @@ boolean LCDIF_Initialize(void)
     LCDIF_START = LCDIF_INT_RESET;                                                                  // Assert LCD controller internal Reset
     LCDIF_START = 0;                                                                                // Release LCD controller internal Reset
 
-    if (LCDIFQueue == NULL)  LCDIFQueue = DL_Create(0);
-    if ((LCDIFQueue == NULL) || !LCDIF_RegisterISR())
+    if (!LCDIF_RegisterISR())
     {
-        if (LCDIFQueue == NULL)
-        {
-            DebugPrint("Failed! (Insufficient memory)\r\n");
-            DebugPrint(" Total used %uKiB\r\n", GetTotalUsedMemory() >> 10);
-        }
-        else DebugPrint("Failed! (Unable to register LCD ISR 0x%02X)\r\n", IRQ_LCD_CODE);
+        DebugPrint("Failed! (Unable to register LCD ISR 0x%02X)\r\n", IRQ_LCD_CODE);
         LCDIF_DisableInterface();
         return false;
     }
@@ -236,6 +338,9 @@ boolean LCDIF_Initialize(void)
 
     if (LCDDRV_Initialize())
     {
+#if defined(LCD_LPTE)
+        LCDIF_TECON = LCDIF_SYNC_EN;                                                                // Transfers wait for the tearing effect signal
+#endif
         LCDIF_INTEN = LCDIF_CPL;                                                                    // Enable LCD interrupts
         DebugPrint("Complete.\r\n");
         return true;
@@ -254,6 +359,7 @@ boolean LCDIF_SetupLayer(TVLINDEX Layer, TPOINT Offset, uint32_t SizeX, uint32_t
     LCDScreen.VLayer[Layer].Enabled = false;
     LCDScreen.VLayer[Layer].Initialized = false;
     LCDIF_WROICON &= ~LCDScreen.VLayer[Layer].LayerEnMask;
+    LCDIFPendingLayers &= ~(1 << Layer);
     if (LCDScreen.VLayer[Layer].FrameBuffer != NULL)
     {
         free(LCDScreen.VLayer[Layer].FrameBuffer);
@@ -275,12 +381,13 @@ boolean LCDIF_SetupLayer(TVLINDEX Layer, TPOINT Offset, uint32_t SizeX, uint32_t
             LCDScreen.VLayer[Layer].FrameBuffer = malloc(n);
             if (LCDScreen.VLayer[Layer].FrameBuffer != NULL)
             {
-                LCDIF_LAYER[Layer]->LCDIF_LWINCON = LCDIF_LROTATE(LCDIF_LR_NO) | LCDIF_LCF(CFormat);
+                LCDScreen.VLayer[Layer].WinCon = LCDIF_LROTATE(LCDIF_LR_NO) | LCDIF_LCF(CFormat);
                 if ((CFormat == LCDIF_LCF_ARGB8888) || (CFormat == LCDIF_LCF_PARGB8888) || (Alpha != 0xFF))
-                    LCDIF_LAYER[Layer]->LCDIF_LWINCON |= LCDIF_LALPHA(Alpha) | LCDIF_LALPHA_EN;
+                    LCDScreen.VLayer[Layer].WinCon |= LCDIF_LALPHA(Alpha) | LCDIF_LALPHA_EN;
 
+                LCDIF_LAYER[Layer]->LCDIF_LWINCON   = LCDScreen.VLayer[Layer].WinCon;
                 LCDIF_LAYER[Layer]->LCDIF_LWINOFFS  = LCDIF_LWINOF_X(Offset.x) | LCDIF_LWINOF_Y(Offset.y);
-                LCDIF_LAYER[Layer]->LCDIF_LWINADD   = (uint32_t)LCDScreen.VLayer[Layer].FrameBuffer;
+                LCDIF_LAYER[Layer]->LCDIF_LWINADD   = (uintptr_t)LCDScreen.VLayer[Layer].FrameBuffer;
                 LCDIF_LAYER[Layer]->LCDIF_LWINSIZE  = LCDIF_LCOLS(SizeX) | LCDIF_LROWS(SizeY);
                 LCDIF_LAYER[Layer]->LCDIF_LWINSCRL  = LCDIF_LSCCOL(0) | LCDIF_LSCROW(0);
                 LCDIF_LAYER[Layer]->LCDIF_LWINMOFS  = LCDIF_LMOFCOL(0) | LCDIF_LMOFROW(0);
@@ -293,6 +400,30 @@ boolean LCDIF_SetupLayer(TVLINDEX Layer, TPOINT Offset, uint32_t SizeX, uint32_t
     return LCDScreen.VLayer[Layer].Initialized;
 }
 
+/*
+The settings below are kept in LCDScreen. With UpdateScreen they are written to the registers
+at once and the screen is updated. Without it the caller sends the updates itself, so the
+registers wait for LCDIF_CommitLayers() as well and a running transfer does not see them.
+*/
+static void LCDIF_WriteLayer(TVLINDEX Layer)
+{
+    pLCONTEXT lc = &LCDScreen.VLayer[Layer];
+
+    LCDIF_LAYER[Layer]->LCDIF_LWINCON = lc->WinCon;
+    LCDIF_LAYER[Layer]->LCDIF_LWINOFFS = LCDIF_LWINOF_X(lc->LayerOffset.x + lc->LayerRgn.l) |
+                                         LCDIF_LWINOF_Y(lc->LayerOffset.y + lc->LayerRgn.t);
+    if (lc->Enabled) LCDIF_WROICON |= lc->LayerEnMask;
+    else LCDIF_WROICON &= ~lc->LayerEnMask;
+
+    LCDIFPendingLayers &= ~(1 << Layer);
+}
+
+static void LCDIF_ApplyLayer(TVLINDEX Layer, boolean UpdateScreen)
+{
+    if (UpdateScreen) LCDIF_WriteLayer(Layer);
+    else LCDIFPendingLayers |= 1 << Layer;
+}
+
 boolean LCDIF_SetLayerEnabled(TVLINDEX Layer, boolean Enabled, boolean UpdateScreen)
 {
     TRECT LayerRect;
@@ -301,10 +432,8 @@ boolean LCDIF_SetLayerEnabled(TVLINDEX Layer, boolean Enabled, boolean UpdateScr
 
     if (LCDScreen.VLayer[Layer].Enabled != Enabled)
     {
-        if (Enabled) LCDIF_WROICON |= LCDScreen.VLayer[Layer].LayerEnMask;
-        else LCDIF_WROICON &= ~LCDScreen.VLayer[Layer].LayerEnMask;
-
         LCDScreen.VLayer[Layer].Enabled = Enabled;
+        LCDIF_ApplyLayer(Layer, UpdateScreen);
 
         if (UpdateScreen)
         {
@@ -320,22 +449,163 @@ boolean LCDIF_SetLayerEnabled(TVLINDEX Layer, boolean Enabled, boolean UpdateScr
     return LCDScreen.VLayer[Layer].Enabled;
 }
 
-void LCDIF_UpdateRectangle(TRECT Rct)
+/*
+Moves the layer on the screen together with its coordinates (LayerRgn),
+the content of the frame buffer is not changed.
+*/
+boolean LCDIF_MoveLayer(TVLINDEX Layer, int16_t dx, int16_t dy, boolean UpdateScreen)
 {
-    uint32_t *Commands, CmdCount;
+    pLCONTEXT lc;
+    TRECT     OldRect, NewRect;
+    int32_t   x, y;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    lc = &LCDScreen.VLayer[Layer];
+    x = lc->LayerOffset.x + lc->LayerRgn.l + dx;
+    y = lc->LayerOffset.y + lc->LayerRgn.t + dy;
+    if ((x < 0) || (y < 0) || (LCDIF_LWINOF_X(x) != x) || (LCDIF_LWINOF_X(y) != y)) return false;   // Out of the register range
+
+    OldRect = GDI_LocalToGlobalRct(&lc->LayerRgn, &lc->LayerOffset);
+    OldRect = GDI_GlobalToLocalRct(&OldRect, &LCDScreen.ScreenOffset);
+
+    lc->LayerRgn.l += dx;
+    lc->LayerRgn.r += dx;
+    lc->LayerRgn.t += dy;
+    lc->LayerRgn.b += dy;
+    LCDIF_ApplyLayer(Layer, UpdateScreen);
 
-    if (GDI_ANDRectangles(&Rct, &LCDScreen.ScreenRgn))
+    if (UpdateScreen && lc->Enabled)
     {
-        Commands = LCDDRV_SetOutputWindow(&Rct, &CmdCount, LCDIF_DATA, LCDIF_CMD);
-        if (Commands != NULL)
-            LCDIF_AddCommandToQueue(Commands, CmdCount, &Rct);
+        NewRect = GDI_LocalToGlobalRct(&lc->LayerRgn, &lc->LayerOffset);
+        NewRect = GDI_GlobalToLocalRct(&NewRect, &LCDScreen.ScreenOffset);
+        if (IsRectsOverlaps(&OldRect, &NewRect))                                                    // Update the bounding rectangle at once
+        {
+            NewRect = Rect(min(OldRect.l, NewRect.l), min(OldRect.t, NewRect.t),
+                           max(OldRect.r, NewRect.r), max(OldRect.b, NewRect.b));
+        }
+        else LCDIF_UpdateRectangle(OldRect);
+        LCDIF_UpdateRectangle(NewRect);
+    }
+    return true;
+}
+
+/*
+Sets the screen position of the layer (LayerOffset), the coordinates inside
+the layer (LayerRgn) and the content of the frame buffer are not changed.
+*/
+boolean LCDIF_SetLayerOffset(TVLINDEX Layer, TPOINT Offset, boolean UpdateScreen)
+{
+    pLCONTEXT lc;
+    TRECT     OldRect;
+    int32_t   x, y;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    lc = &LCDScreen.VLayer[Layer];
+    x = Offset.x + lc->LayerRgn.l;
+    y = Offset.y + lc->LayerRgn.t;
+    if ((x < 0) || (y < 0) || (LCDIF_LWINOF_X(x) != x) || (LCDIF_LWINOF_X(y) != y)) return false;   // Out of the register range
+
+    OldRect = LCDIF_GetLayerScreenRect(Layer);
+    lc->LayerOffset = Offset;
+    LCDIF_ApplyLayer(Layer, UpdateScreen);
+
+    if (UpdateScreen && lc->Enabled)
+    {
+        LCDIF_UpdateRectangle(OldRect);
+        LCDIF_UpdateRectangle(LCDIF_GetLayerScreenRect(Layer));
     }
+    return true;
+}
+
+/* Alpha 0xFF turns the blending off, except for the formats with the alpha channel. */
+boolean LCDIF_SetLayerAlpha(TVLINDEX Layer, uint8_t Alpha, boolean UpdateScreen)
+{
+    uint32_t LWinCon;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    LWinCon = LCDScreen.VLayer[Layer].WinCon & ~(LCDIF_LALPHA(0xFF) | LCDIF_LALPHA_EN);
+    if ((LCDScreen.VLayer[Layer].ColorFormat == LCDIF_LCF_ARGB8888) ||
+            (LCDScreen.VLayer[Layer].ColorFormat == LCDIF_LCF_PARGB8888) || (Alpha != 0xFF))
+        LWinCon |= LCDIF_LALPHA(Alpha) | LCDIF_LALPHA_EN;
+    LCDScreen.VLayer[Layer].WinCon = LWinCon;
+    LCDIF_ApplyLayer(Layer, UpdateScreen);
+
+    if (UpdateScreen && LCDScreen.VLayer[Layer].Enabled)
+        LCDIF_UpdateRectangle(LCDIF_GetLayerScreenRect(Layer));
+
+    return true;
+}
+
+uint8_t LCDIF_GetLayerAlpha(TVLINDEX Layer)
+{
+    uint32_t LWinCon;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return 0xFF;
+
+    LWinCon = LCDScreen.VLayer[Layer].WinCon;
+    return (LWinCon & LCDIF_LALPHA_EN) ? LWinCon & LCDIF_LALPHA(0xFF) : 0xFF;
+}
+
+/* The layer rectangle in the screen coordinates, not clipped by the screen. */
+TRECT LCDIF_GetLayerScreenRect(TVLINDEX Layer)
+{
+    TRECT Rct;
+
+    if (Layer >= LCDIF_NUMLAYERS) return Rect(0, 0, -1, -1);
+
+    Rct = GDI_LocalToGlobalRct(&LCDScreen.VLayer[Layer].LayerRgn, &LCDScreen.VLayer[Layer].LayerOffset);
+    return GDI_GlobalToLocalRct(&Rct, &LCDScreen.ScreenOffset);
+}
+
+/*
+An enabled layer without alpha blending hides the layers below it,
+unless the source key shows them through the keyed pixels.
+*/
+boolean LCDIF_IsLayerOpaque(TVLINDEX Layer)
+{
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized ||
+            !LCDScreen.VLayer[Layer].Enabled) return false;
+
+    return (LCDScreen.VLayer[Layer].WinCon & (LCDIF_LALPHA_EN | LCDIF_LSRCKEY_EN)) == 0;
+}
+
+/*
+Writes the layer settings changed without UpdateScreen to the registers.
+Called between the transfers, when the controller does not read the layers.
+*/
+void LCDIF_CommitLayers(void)
+{
+    uint32_t i;
+
+    for(i = 0; i < LCDIF_NUMLAYERS; i++)
+        if (LCDIFPendingLayers & (1 << i)) LCDIF_WriteLayer(i);
+}
+
+/* Waits for a free descriptor if the queue is full. */
+void LCDIF_UpdateRectangle(TRECT Rct)
+{
+    LCDIF_QueueUpdate(Rct, NULL, NULL, true, NULL);
+}
+
+/*
+Does not wait, returns LQS_FULL if there is no free descriptor.
+The Handler, if given, is called through the event manager when the update is sent,
+Fence receives the fence of the update.
+*/
+TLCDQSTATUS LCDIF_SubmitUpdate(TRECT Rct, void (*Handler)(uint32_t, void *), void *Object, uint32_t *Fence)
+{
+    return LCDIF_QueueUpdate(Rct, Handler, Object, false, Fence);
 }
 
 void LCDIF_UpdateRectangleBlocked(pRECT Rct)
 {
+    uint32_t Fence;
+
     if (Rct == NULL) return;
 
-    LCDIF_UpdateRectangle(*Rct);
-    while(LCDIF_IsQueueRunning());
+    if (LCDIF_QueueUpdate(*Rct, NULL, NULL, true, &Fence) == LQS_QUEUED)
+        while(!LCDIF_IsFenceReached(Fence)) LCDIF_RestartQueue();
 }
@@ -21,7 +21,7 @@
 
 #include "gditypes.h"
 
-#define MAX_LCDQUEUE_SIZE           128
+#define MAX_LCDQUEUE_SIZE           128                                                             // Descriptors in the command ring, the power of 2
 
 #define LCD_SERIAL_CLOCK_REG        (*(volatile uint32_t *)(CONFIG_BASE + 0x11C))
 #define LCD_SERIAL_CLOCK_MASK       0x70
@@ -300,6 +300,7 @@ typedef struct tag_TLCONTEXT
     uint32_t LayerEnMask;
     uint8_t  BPP;
     TCFORMAT ColorFormat;
+    uint32_t WinCon;                                                                                // LCDIF_LWINCON of the layer
     void     *FrameBuffer;
 } TLCONTEXT, *pLCONTEXT;
 
@@ -316,21 +317,59 @@ typedef struct tag_TLCDCMD
 {
     TRECT     UpdateRect;
     uint32_t  CMDCount;
-    uint32_t  *Commands;
+    uint32_t  Commands[LCDIF_MAXCOMMANDS];
 } TLCDCMD, *pLCDCMD;
 
+typedef enum tag_LCDQSTATUS
+{
+    LQS_QUEUED,                                                                                     // The update is in the queue
+    LQS_CLIPPED,                                                                                    // The rectangle is out of the screen, nothing to send
+    LQS_FULL,                                                                                       // No free descriptors, try again later
+    LQS_ERROR                                                                                       // The LCD driver did not make the commands
+} TLCDQSTATUS;
+
+typedef struct tag_LCDDONE
+{
+    void     (*Handler)(uint32_t, void *);                                                          // Called from the main loop when sent
+    void     *Object;
+    uint32_t Fence;
+} TLCDDONE, *pLCDDONE;
+
+typedef struct tag_LCDIFSTAT
+{
+    uint32_t Transfers;                                                                             // Completed runs of the command queue
+    uint32_t LastTime;                                                                              // Duration of the last run in us
+    uint32_t MaxTime;
+    uint32_t Updates;                                                                               // Queued update commands
+    uint32_t Stalls;                                                                                // Updates found the queue full
+} TLCDIFSTAT, *pLCDIFSTAT;
+
 extern TSCREEN LCDScreen;
+extern const uint8_t CFormatToBPP[];
 
 extern void LCDIF_DisableInterface(void);
 extern boolean LCDIF_Initialize(void);
 extern void LCDIF_WriteCommand(uint8_t Cmd);
 extern void LCDIF_WriteData(uint8_t Data);
 extern uint8_t LCDIF_ReadData(void);
-extern boolean LCDIF_AddCommandToQueue(uint32_t *CmdArray, uint32_t CmdCount, pRECT UpdateRect);
+extern boolean LCDIF_AddCommandToQueue(const uint32_t *CmdArray, uint32_t CmdCount, pRECT UpdateRect);
 extern boolean LCDIF_SetupLayer(TVLINDEX Layer, TPOINT Offset, uint32_t SizeX, uint32_t SizeY,
                                 TCFORMAT CFormat, uint8_t Alpha);
 extern boolean LCDIF_SetLayerEnabled(TVLINDEX Layer, boolean Enabled, boolean UpdateScreen);
+extern boolean LCDIF_MoveLayer(TVLINDEX Layer, int16_t dx, int16_t dy, boolean UpdateScreen);
+extern boolean LCDIF_SetLayerOffset(TVLINDEX Layer, TPOINT Offset, boolean UpdateScreen);
+extern boolean LCDIF_SetLayerAlpha(TVLINDEX Layer, uint8_t Alpha, boolean UpdateScreen);
+extern uint8_t LCDIF_GetLayerAlpha(TVLINDEX Layer);
+extern TRECT LCDIF_GetLayerScreenRect(TVLINDEX Layer);
+extern boolean LCDIF_IsLayerOpaque(TVLINDEX Layer);
+extern void LCDIF_CommitLayers(void);
 extern void LCDIF_UpdateRectangle(TRECT Rct);
+extern TLCDQSTATUS LCDIF_SubmitUpdate(TRECT Rct, void (*Handler)(uint32_t, void *), void *Object, uint32_t *Fence);
 extern void LCDIF_UpdateRectangleBlocked(pRECT Rct);
+extern uint32_t LCDIF_GetFence(void);
+extern boolean LCDIF_IsFenceReached(uint32_t Fence);
+extern void LCDIF_ProcessCompletions(void);
+extern boolean LCDIF_IsTransferComplete(void);
+extern void LCDIF_GetTransferStat(pLCDIFSTAT Stat, boolean Reset);
 
 #endif /* _LCDIF_H_ */
@@ -28,6 +28,7 @@ int main(void)
     while(1)
     {
         EM_ProcessEvents();
+        GUI_ProcessFrame();
 
         /* Restart watchdog */
         RGU_RestartWDT();
@@ -95,6 +95,37 @@ ctz_hash_table:
     .byte   0x09, 0xff, 0xff, 0x18, 0xff, 0xff, 0x14, 0x1a
     .byte   0x1e, 0xff, 0xff, 0xff, 0xff, 0x17, 0xff, 0x13
     .byte   0x1d, 0xff, 0x16, 0x12, 0x1c, 0x11, 0x10
+///////////////////////////////////////////////////////////////////////////////////////////////////
+    .align  2
+    .globl  FillWords
+    .type   FillWords, %function
+    .func   FillWords
+FillWords:
+    stmfd   sp!,{r4-r9, lr}                                                                         // void FillWords(uint32_t *Dst, uint32_t Value, uint32_t Count);
+    mov     r3, r1                                                                                  // Dst must be word aligned
+    mov     r4, r1
+    mov     r5, r1
+    mov     r6, r1
+    mov     r7, r1
+    mov     r8, r1
+    mov     r9, r1
+
+    subs    r2, r2, #8
+    blt     FillWordsTail
+FillWordsLoop:
+    stmia   r0!,{r1, r3-r9}                                                                         // 8 words per store
+    subs    r2, r2, #8
+    bge     FillWordsLoop
+
+FillWordsTail:
+    tst     r2, #4
+    stmiane r0!,{r1, r3-r5}
+    tst     r2, #2
+    stmiane r0!,{r1, r3}
+    tst     r2, #1
+    strne   r1, [r0]
+    ldmfd   sp!,{r4-r9, pc}
+    .endfunc
 ///////////////////////////////////////////////////////////////////////////////////////////////////
     .align  2
     .globl  GetCPUFreqTicks
@@ -101,8 +101,8 @@ static int32_t DL_IndexOfItem(pDLIST DList, pDLITEM Item)
 
 static pDLITEM DL_ItemByIndex(pDLIST DList, uint32_t Index)
 {
-    int32_t i;
-    pDLITEM tmpItem = NULL;
+    uint32_t i;
+    pDLITEM  tmpItem = NULL;
 
     if ((DList != NULL) && (Index < DList->Count))
     {
@@ -547,6 +547,40 @@ boolean DL_DeleteLastItem(pDLIST DList)
     return Result;
 }
 
+/* Moves the item after the item After, to the beginning of the list if After is NULL. */
+boolean DL_MoveItemAfter(pDLIST DList, pDLITEM Item, pDLITEM After)
+{
+    uint32_t intflags;
+
+    if ((DList == NULL) || (Item == NULL) || (Item == After)) return false;
+
+    intflags = DisableInterrupts();
+    if (Item->Prev != After)
+    {
+        /* Remove item from old place */
+        if (Item->Prev != NULL)
+            Item->Prev->Next = Item->Next;
+        else DList->First = Item->Next;
+
+        if (Item->Next != NULL)
+            Item->Next->Prev = Item->Prev;
+        else DList->Last = Item->Prev;
+
+        /* Insert item to new place */
+        Item->Prev = After;
+        Item->Next = (After != NULL) ? After->Next : DList->First;
+
+        if (After != NULL) After->Next = Item;
+        else DList->First = Item;
+
+        if (Item->Next != NULL) Item->Next->Prev = Item;
+        else DList->Last = Item;
+    }
+    RestoreInterrupts(intflags);
+
+    return true;
+}
+
 boolean DL_MoveItemToIndex(pDLIST DList, uint32_t OldIndex, uint32_t NewIndex)
 {
     boolean  Result = false;
@@ -21,11 +21,19 @@
 #include "systemconfig.h"
 #include "evmngr.h"
 
-static pDLIST EventsList;
+static pDLIST   EventsList;
+static uint32_t EventsPeak;                                                                         // Maximum depth of the queue since the last reset
 
 static boolean EM_AddEvent(pEVENT Event)
 {
-    return ((Event == NULL) || (DL_AddItem(EventsList, Event) == NULL)) ? false : true;
+    uint32_t Count;
+
+    if ((Event == NULL) || (DL_AddItem(EventsList, Event) == NULL)) return false;
+
+    Count = DL_GetItemsCount(EventsList);
+    if (Count > EventsPeak) EventsPeak = Count;
+
+    return true;
 }
 
 static pEVENT EM_GetTopEvent(void)
@@ -62,6 +70,14 @@ boolean EM_PostEvent(TEVTYPE Type, void *Object, void *Param, uint32_t ParamSz)
     return false;
 }
 
+uint32_t EM_GetQueueDepth(uint32_t *Peak, boolean ResetPeak)
+{
+    if (Peak != NULL) *Peak = EventsPeak;
+    if (ResetPeak) EventsPeak = 0;
+
+    return DL_GetItemsCount(EventsList);
+}
+
 void EM_ProcessEvents(void)
 {
     pEVENT tmpEvent;
@@ -78,8 +94,7 @@ void EM_ProcessEvents(void)
 
             if (tmpEvent->ParamSz)
             {
-//                GUI_OnPenPressed(TSEvent);
-                DebugPrint("Pen %u Pressed x= %d, y= %d\r\n", TSEvent->PenIndex, TSEvent->PXY.x, TSEvent->PXY.y);
+                GUI_OnPenPressed(TSEvent);
             }
         }
         break;
@@ -89,8 +104,7 @@ void EM_ProcessEvents(void)
 
             if (tmpEvent->ParamSz)
             {
-//                GUI_OnPenReleased(TSEvent);
-                DebugPrint("Pen %u Released x= %d, y= %d\r\n", TSEvent->PenIndex, TSEvent->PXY.x, TSEvent->PXY.y);
+                GUI_OnPenReleased(TSEvent);
             }
         }
         break;
@@ -100,14 +114,10 @@ void EM_ProcessEvents(void)
 
             if (tmpEvent->ParamSz)
             {
-//                GUI_OnPenMoved(TSEvent);
-                DebugPrint("Pen %u Moved x= %d, y= %d\r\n", TSEvent->PenIndex, TSEvent->PXY.x, TSEvent->PXY.y);
+                GUI_OnPenMoved(TSEvent);
             }
         }
         break;
-        case ET_ONPAINT:
-            GUI_OnPaintHandler((pPAINTEV)tmpEvent->Param);
-            break;
         case ET_PWRKEY:
             break;
         case ET_ONTIMER:
@@ -123,6 +133,7 @@ void EM_ProcessEvents(void)
         }
         free(tmpEvent);
     }
+    LCDIF_ProcessCompletions();                                                                     // The handlers of the sent LCD updates
 }
 
 
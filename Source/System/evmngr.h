@@ -26,8 +26,6 @@ typedef enum tag_EVTYPE
     ET_PENPRESSED,
     ET_PENRELEASED,
     ET_PENMOVED,
-    /* GUI events */
-    ET_ONPAINT,
     /* System events */
     ET_PWRKEY,
     ET_ONTIMER
@@ -43,6 +41,7 @@ typedef struct tag_EVENT
 
 extern boolean EM_Initialize(void);
 extern boolean EM_PostEvent(TEVTYPE Type, void *Object, void *Param, uint32_t ParamSz);
+extern uint32_t EM_GetQueueDepth(uint32_t *Peak, boolean ResetPeak);
 extern void EM_ProcessEvents(void);
 
 #endif /* _EVMNGR_H_ */
@@ -27,6 +27,7 @@ extern uint32_t EnableInterrupts(void);
 extern uint32_t DisableInterrupts(void);                                                            // From asmutils.s
 extern void RestoreInterrupts(uint32_t flags);                                                      // From asmutils.s
 extern uint32_t CTZ(uint32_t Value);                                                                // From asmutils.s
+extern void FillWords(uint32_t *Dst, uint32_t Value, uint32_t Count);                               // From asmutils.s
 extern uint32_t GetCPUFreqTicks(void);                                                              // from asmutils.s
 extern uint32_t GetCPUFrequency(void);
 
@@ -36,10 +36,14 @@
 
 #define _DEBUG_             (1)
 #define _USEBATTERY_        (1)
+#define _FILLBENCHMARK_     (0)                                                                     // Print the fill rates at start up
 #define USEINTERRUPTS
 #define VIBRVoltage         VIBR_VO18V
 
 #define SystemMemorySize    (3 * 1024 * 1024)
+#define GlyphCacheSize      (64 * 1024)                                                             // Pool of the pre-rendered glyphs
+#define BackStoreBudget     (512 * 1024)                                                            // Backing stores of the retained windows
+#define GUIFrameRate        30                                                                      // Target frames per second, 0 - paint at once
 #define SysCacheSize        CACHE_32kB
 #define LRTMRHWTIMER        GP_TIMER1
 #define LRTMRFrequency      100
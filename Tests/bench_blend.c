@@ -0,0 +1,113 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+#include "blendref.h"
+
+/*
+Throughput of the alpha blending kernels compared with the per-channel reference,
+a full layer is blended by a constant alpha fill and by ARGB8888 and PARGB8888 bitmaps.
+Usage: bench_blend [pixels per case]
+*/
+
+#define LAYER_SIZE      240
+
+static const TCFORMAT LayerFormats[] = {CF_RGB565, CF_ARGB8888};
+static const char     *LayerNames[] = {"RGB565", "ARGB8888"};
+
+static TBITMAP Bitmaps[2];
+static TRECT   LayerRect;
+
+static void FillKernel(pLCONTEXT lc, uint32_t Index)
+{
+    GDI_FillRectangleAlphaX(lc, &LayerRect, 0x80336699 + Index);
+}
+
+static void FillReference(pLCONTEXT lc, uint32_t Index)
+{
+    REF_FillRectangleAlpha(lc, &LayerRect, 0x80336699 + Index);
+}
+
+static void BlendKernel(pLCONTEXT lc, uint32_t Index)
+{
+    GDI_BitBltX(lc, &LayerRect, &Bitmaps[Index], Point(0, 0), BM_BLEND, 0);
+}
+
+static void BlendReference(pLCONTEXT lc, uint32_t Index)
+{
+    REF_BlendBitmap(lc, &LayerRect, &Bitmaps[Index], Point(0, 0));
+}
+
+static double Rate(void (*Blend)(pLCONTEXT, uint32_t), pLCONTEXT lc, uint32_t Index, uint32_t Pixels)
+{
+    uint32_t Count = Pixels / (LAYER_SIZE * LAYER_SIZE) + 1, i;
+    double   Time = HOST_Time();
+
+    for(i = 0; i < Count; i++) Blend(lc, Index);
+    Time = HOST_Time() - Time;
+
+    return (double)Count * LAYER_SIZE * LAYER_SIZE / Time / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t  Pixels = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1 << 24;
+    TLCONTEXT lc = {0};
+    uint32_t  i, j;
+
+    LayerRect = Rect(0, 0, LAYER_SIZE - 1, LAYER_SIZE - 1);
+    lc.LayerRgn = LayerRect;
+    lc.FrameBuffer = calloc(LAYER_SIZE * LAYER_SIZE, sizeof(uint32_t));
+    for(i = 0; i < 2; i++)
+    {
+        uint32_t *Data = malloc(LAYER_SIZE * LAYER_SIZE * sizeof(uint32_t));
+
+        Bitmaps[i].ColorFormat = (i) ? CF_PARGB8888 : CF_ARGB8888;
+        Bitmaps[i].Width = Bitmaps[i].Height = LAYER_SIZE;
+        Bitmaps[i].Data = Data;
+        for(j = 0; j < LAYER_SIZE * LAYER_SIZE; j++)                                                // Antialiased shape: mostly 0 or 255
+        {
+            uint32_t Alpha = HOST_Random() % 4;
+
+            Alpha = (Alpha == 0) ? 0 : (Alpha == 1) ? 0xFF : HOST_Random() & 0xFF;
+            Data[j] = (Alpha << 24) | ((i) ? 0x00010101 * (Alpha / 2) : HOST_Random() & 0x00FFFFFF);
+        }
+    }
+
+    printf("bench_blend: %ux%u layer, MPix/s\n", LAYER_SIZE, LAYER_SIZE);
+    printf("%-10s %-14s %12s %12s\n", "layer", "operation", "reference", "kernel");
+    for(i = 0; i < sizeof(LayerFormats) / sizeof(LayerFormats[0]); i++)
+    {
+        lc.ColorFormat = LayerFormats[i];
+        lc.BPP = CFormatToBPP[LayerFormats[i]];
+
+        printf("%-10s %-14s %12.1f %12.1f\n", LayerNames[i], "fill, alpha", Rate(FillReference, &lc, 0, Pixels),
+               Rate(FillKernel, &lc, 0, Pixels));
+        printf("%-10s %-14s %12.1f %12.1f\n", LayerNames[i], "blit ARGB", Rate(BlendReference, &lc, 0, Pixels),
+               Rate(BlendKernel, &lc, 0, Pixels));
+        printf("%-10s %-14s %12.1f %12.1f\n", LayerNames[i], "blit PARGB", Rate(BlendReference, &lc, 1, Pixels),
+               Rate(BlendKernel, &lc, 1, Pixels));
+    }
+    for(i = 0; i < 2; i++) free(Bitmaps[i].Data);
+    free(lc.FrameBuffer);
+
+    return EXIT_SUCCESS;
+}
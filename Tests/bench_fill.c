@@ -0,0 +1,111 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+/*
+Fill rate of GDI_FillRectangleX per frame buffer format and rectangle size,
+compared with a pixel by pixel loop. The result of both is checked to match.
+Usage: bench_fill [pixels per case]
+*/
+
+#define LAYER_SIZE      240
+
+typedef struct tag_FILLCASE
+{
+    const char *Name;
+    TRECT       Rct;
+} TFILLCASE, *pFILLCASE;
+
+static void FillReference(pLCONTEXT lc, pRECT Rct, uint32_t Color)
+{
+    int32_t x, y;
+
+    for(y = Rct->t; y <= Rct->b; y++)
+        for(x = Rct->l; x <= Rct->r; x++)
+        {
+            uint8_t *p = GDI_GetPixelPtr(lc, Point(x, y));
+
+            if (lc->BPP == 2) *(uint16_t *)p = RGB_565(Color);
+            else *(uint32_t *)p = Color;
+        }
+}
+
+static double Rate(void (*Fill)(pLCONTEXT, pRECT, uint32_t), pLCONTEXT lc, pRECT Rct, uint32_t Pixels)
+{
+    uint32_t Size = (Rct->r - Rct->l + 1) * (Rct->b - Rct->t + 1);
+    uint32_t Count = Pixels / Size + 1, i;
+    double   Time = HOST_Time();
+
+    for(i = 0; i < Count; i++) Fill(lc, Rct, i);
+    Time = HOST_Time() - Time;
+
+    return (double)Count * Size / Time / 1e6;
+}
+
+int main(int argc, char *argv[])
+{
+    static const TCFORMAT Formats[] = {CF_RGB565, CF_ARGB8888};
+    static const char     *FormatNames[] = {"RGB565", "ARGB8888"};
+    TFILLCASE Cases[] =
+    {
+        {"1x1", Rect(0, 0, 0, 0)},
+        {"4x4", Rect(0, 0, 3, 3)},
+        {"16x16", Rect(0, 0, 15, 15)},
+        {"64x64+1", Rect(1, 1, 64, 64)},
+        {"240x1", Rect(0, 0, 239, 0)},
+        {"1x240", Rect(0, 0, 0, 239)},
+        {"239x240+1", Rect(1, 0, 239, 239)},
+        {"240x240", Rect(0, 0, 239, 239)}
+    };
+    uint32_t  Pixels = (argc > 1) ? strtoul(argv[1], NULL, 0) : 1 << 26;
+    TLCONTEXT lc = {0}, ref = {0};
+    uint32_t  i, j;
+
+    lc.LayerRgn = Rect(0, 0, LAYER_SIZE - 1, LAYER_SIZE - 1);
+    lc.FrameBuffer = calloc(LAYER_SIZE * LAYER_SIZE, sizeof(uint32_t));
+    ref = lc;
+    ref.FrameBuffer = calloc(LAYER_SIZE * LAYER_SIZE, sizeof(uint32_t));
+
+    printf("bench_fill: %ux%u layer, MPix/s\n", LAYER_SIZE, LAYER_SIZE);
+    printf("%-10s %-10s %12s %12s\n", "format", "rect", "pixel loop", "FillRect");
+    for(i = 0; i < sizeof(Formats) / sizeof(Formats[0]); i++)
+    {
+        lc.ColorFormat = ref.ColorFormat = Formats[i];
+        lc.BPP = ref.BPP = (Formats[i] == CF_RGB565) ? 2 : 4;
+        for(j = 0; j < sizeof(Cases) / sizeof(Cases[0]); j++)
+        {
+            pRECT Rct = &Cases[j].Rct;
+
+            FillReference(&ref, Rct, 0x123456);
+            GDI_FillRectangleX(&lc, Rct, 0x123456);
+            CHECK(!memcmp(lc.FrameBuffer, ref.FrameBuffer, LAYER_SIZE * LAYER_SIZE * sizeof(uint32_t)),
+                  "%s %s: the fill differs from the reference", FormatNames[i], Cases[j].Name);
+
+            printf("%-10s %-10s %12.1f %12.1f\n", FormatNames[i], Cases[j].Name,
+                   Rate(FillReference, &ref, Rct, Pixels), Rate(GDI_FillRectangleX, &lc, Rct, Pixels));
+        }
+    }
+    free(lc.FrameBuffer);
+    free(ref.FrameBuffer);
+
+    return HOST_Result("bench_fill");
+}
@@ -0,0 +1,77 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+#include "hostlcdif.h"
+
+/*
+Update rate of the LCDIF command queue with the drivers of hostlcdif.h, the hardware
+drains the queue at once. The producer queues Burst updates before the queue is drained.
+Usage: bench_lcdif [updates]
+Another version of the drivers is measured by building it from that tree:
+    make -C Tests /tmp/old/bench_lcdif SRC=<tree>/Source OUT=/tmp/old WERROR=
+*/
+
+static double Rate(uint32_t Updates, uint32_t Burst)
+{
+    uint32_t i;
+    double   Time = HOST_Time();
+
+    for(i = 0; i < Updates; i++)
+    {
+        LCDIF_UpdateRectangle(Rect(i & 63, 10, 100 + (i & 31), 100));
+        if (!(i % Burst)) HOST_RunLCDIF();
+    }
+    HOST_RunLCDIF();
+    Time = HOST_Time() - Time;
+
+    return Time / Updates;
+}
+
+int main(int argc, char *argv[])
+{
+    static const uint32_t Bursts[] = {1, 16};
+    uint32_t Updates = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000000;
+    uint32_t i;
+
+    CHECK(LCDIF_Initialize(), "the LCD interface is not initialized");
+
+    LCDIF_UpdateRectangle(Rect(10, 20, 109, 69));
+    CHECK((LCDIF_START & LCDIF_RUN) && (LCDIF_WROISIZE == (LCDIF_WROICOL(100) | LCDIF_WROIROW(50))) &&
+          (LCDIF_WROIOFS == (LCDIF_WROIOFX(10) | LCDIF_WROIOFY(20))) && (LCDIF_WROICON & LCDIF_ENC),
+          "the update is not loaded to the controller");
+    HOST_RunLCDIF();
+    LCDIF_UpdateRectangle(Rect(300, 300, 310, 310));
+    CHECK(!(LCDIF_START & LCDIF_RUN), "the update out of the screen is queued");
+    if (HostFailures) return HOST_Result("bench_lcdif");
+
+    printf("bench_lcdif: %u updates\n", Updates);
+    printf("%-8s %16s %12s\n", "burst", "M updates/s", "ns/update");
+    for(i = 0; i < sizeof(Bursts) / sizeof(Bursts[0]); i++)
+    {
+        double Time = Rate(Updates, Bursts[i]);
+
+        printf("%-8u %16.1f %12.0f\n", Bursts[i], 1e-6 / Time, Time * 1e9);
+    }
+    CHECK(!(LCDIF_START & LCDIF_RUN), "the queue is not drained");
+
+    return HOST_Result("bench_lcdif");
+}
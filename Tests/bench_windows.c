@@ -0,0 +1,116 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+/*
+Cost of the paint loop for N windows and M invalidated rectangles per frame.
+Every frame invalidates random parts of random windows and paints them,
+the time covers GUI_Invalidate() and GUI_ProcessPaint().
+Usage: bench_windows [frames [seed]]
+*/
+
+#define SCREEN_SIZE     240
+#define MAX_WINDOWS     64
+
+static const uint32_t WinCounts[] = {4, 16, 64};
+static const uint32_t InvCounts[] = {1, 8, 32};
+
+static pWIN Windows[MAX_WINDOWS];
+
+static TRECT RandomSubRect(pRECT Rct)
+{
+    int32_t l = HOST_RandomRange(Rct->l, Rct->r);
+    int32_t t = HOST_RandomRange(Rct->t, Rct->b);
+
+    return Rect(l, t, HOST_RandomRange(l, Rct->r), HOST_RandomRange(t, Rct->b));
+}
+
+static void CreateWindows(uint32_t Count)
+{
+    uint32_t i;
+
+    for(i = 0; i < Count; i++)
+    {
+        int32_t SizeX = HOST_RandomRange(20, 120), SizeY = HOST_RandomRange(20, 120);
+        int32_t l = HOST_RandomRange(0, SCREEN_SIZE - SizeX), t = HOST_RandomRange(0, SCREEN_SIZE - SizeY);
+
+        Windows[i] = GUI_CreateWindow(NULL, Rect(l, t, l + SizeX - 1, t + SizeY - 1), NULL, LCDIF_LAYER0,
+                                      HOST_Random() & 0xFFFFFF, GF_VISIBLE);
+    }
+}
+
+static void DestroyWindows(uint32_t Count)
+{
+    while(Count--) GUI_DestroyObject((pGUIHEADER)Windows[Count]);
+}
+
+static void Run(uint32_t WinCount, uint32_t InvCount, uint32_t Frames)
+{
+    TPAINTSTAT Stat;
+    double     Time;
+    uint32_t   i, j;
+
+    CreateWindows(WinCount);
+    GUI_InvalidateLayer(LCDIF_LAYER0, &LCDScreen.ScreenRgn);
+    GUI_ProcessPaint();
+    GUI_GetPaintStat(&Stat, true);
+    HOST_ResetLCDStat();
+
+    Time = HOST_Time();
+    for(i = 0; i < Frames; i++)
+    {
+        for(j = 0; j < InvCount; j++)
+        {
+            pWIN  Win = Windows[HOST_Random() % WinCount];
+            TRECT Rct = RandomSubRect(&Win->Head.Position);
+
+            GUI_Invalidate((pGUIHEADER)Win, &Rct);
+        }
+        GUI_ProcessPaint();
+    }
+    Time = HOST_Time() - Time;
+    GUI_GetPaintStat(&Stat, true);
+
+    printf("%8u %8u %12.2f %14u %12u %10.1f\n", WinCount, InvCount, Time * 1e6 / Frames,
+           Stat.InvalidatedPixels / Frames, Stat.PaintedPixels / Frames, (double)HostLCD.Updates / Frames);
+
+    DestroyWindows(WinCount);
+    GUI_ProcessPaint();
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t Frames = (argc > 1) ? strtoul(argv[1], NULL, 0) : 2000;
+    uint32_t Seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0x2020;
+    uint32_t i, j;
+
+    HOST_SeedRandom(Seed);
+    HOST_SetupScreen(SCREEN_SIZE, SCREEN_SIZE);
+
+    printf("bench_windows: %ux%u screen, %u frames\n", SCREEN_SIZE, SCREEN_SIZE, Frames);
+    printf("%8s %8s %12s %14s %12s %10s\n", "windows", "rects", "us/frame", "invalidated", "painted", "updates");
+    for(i = 0; i < sizeof(WinCounts) / sizeof(WinCounts[0]); i++)
+        for(j = 0; j < sizeof(InvCounts) / sizeof(InvCounts[0]); j++)
+            Run(WinCounts[i], InvCounts[j], Frames);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,145 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include <math.h>
+#include "systemconfig.h"
+#include "blendref.h"
+
+void REF_ReadPixel(TCFORMAT Format, uint8_t *p, TREFPIXEL c)
+{
+    uint32_t Pixel;
+
+    switch (Format)
+    {
+    case CF_RGB565:
+        Pixel = *(uint16_t *)p;
+        c[0] = (Pixel & 0x1F) * 255.0 / 31;                                                         // Red is in the low bits like in 0xAABBGGRR
+        c[1] = ((Pixel >> 5) & 0x3F) * 255.0 / 63;
+        c[2] = ((Pixel >> 11) & 0x1F) * 255.0 / 31;
+        c[3] = 255;
+        return;
+    case CF_RGB888:
+        c[0] = p[0];
+        c[1] = p[1];
+        c[2] = p[2];
+        c[3] = 255;
+        return;
+    default:
+        Pixel = *(uint32_t *)p;
+        c[0] = Pixel & 0xFF;
+        c[1] = (Pixel >> 8) & 0xFF;
+        c[2] = (Pixel >> 16) & 0xFF;
+        c[3] = (Format == CF_xRGB8888) ? 255 : Pixel >> 24;
+        return;
+    }
+}
+
+void REF_Blend(TREFPIXEL c, uint32_t Src, boolean Premul)
+{
+    double   a = (Src >> 24) / 255.0;
+    uint32_t i;
+
+    for(i = 0; i < 3; i++)
+    {
+        double s = (Src >> (i * 8)) & 0xFF;
+
+        c[i] = ((Premul) ? s : s * a) + c[i] * (1 - a);
+    }
+    c[3] = (Src >> 24) + c[3] * (1 - a);
+}
+
+static uint32_t REF_Round(double v, uint32_t Max)
+{
+    v = v * Max / 255 + 0.5;
+
+    return (v > Max) ? Max : (uint32_t)v;
+}
+
+void REF_WritePixel(TCFORMAT Format, uint8_t *p, TREFPIXEL c)
+{
+    switch (Format)
+    {
+    case CF_RGB565:
+        *(uint16_t *)p = REF_Round(c[0], 31) | (REF_Round(c[1], 63) << 5) | (REF_Round(c[2], 31) << 11);
+        return;
+    case CF_RGB888:
+        p[0] = REF_Round(c[0], 255);
+        p[1] = REF_Round(c[1], 255);
+        p[2] = REF_Round(c[2], 255);
+        return;
+    default:
+        *(uint32_t *)p = REF_Round(c[0], 255) | (REF_Round(c[1], 255) << 8) |
+                         (REF_Round(c[2], 255) << 16) | (REF_Round(c[3], 255) << 24);
+        return;
+    }
+}
+
+/* The largest difference of the channels in the least significant bits of the format. */
+double REF_Error(TCFORMAT Format, uint8_t *p, TREFPIXEL c)
+{
+    static const double Scale565[] = {31.0 / 255, 63.0 / 255, 31.0 / 255};
+    TREFPIXEL           Pixel;
+    double              Error = 0;
+    uint32_t            i, Channels = (Format == CF_ARGB8888) || (Format == CF_PARGB8888) ? 4 : 3;
+
+    REF_ReadPixel(Format, p, Pixel);
+    for(i = 0; i < Channels; i++)
+    {
+        double e = fabs(Pixel[i] - c[i]);
+
+        if (Format == CF_RGB565) e *= Scale565[i];
+        if (e > Error) Error = e;
+    }
+    return Error;
+}
+
+void REF_FillRectangleAlpha(pLCONTEXT lc, pRECT Rct, uint32_t Color)
+{
+    int32_t x, y;
+
+    for(y = Rct->t; y <= Rct->b; y++)
+        for(x = Rct->l; x <= Rct->r; x++)
+        {
+            uint8_t   *p = GDI_GetPixelPtr(lc, Point(x, y));
+            TREFPIXEL c;
+
+            REF_ReadPixel(lc->ColorFormat, p, c);
+            REF_Blend(c, Color, false);
+            REF_WritePixel(lc->ColorFormat, p, c);
+        }
+}
+
+void REF_BlendBitmap(pLCONTEXT lc, pRECT Rct, pBITMAP Bitmap, TPOINT SrcPt)
+{
+    uint32_t *s = Bitmap->Data;
+    int32_t  x, y;
+
+    for(y = Rct->t; y <= Rct->b; y++)
+        for(x = Rct->l; x <= Rct->r; x++)
+        {
+            uint8_t   *p = GDI_GetPixelPtr(lc, Point(x, y));
+            TREFPIXEL c;
+
+            REF_ReadPixel(lc->ColorFormat, p, c);
+            REF_Blend(c, s[(SrcPt.y + y - Rct->t) * Bitmap->Width + SrcPt.x + x - Rct->l],
+                      Bitmap->ColorFormat == CF_PARGB8888);
+            REF_WritePixel(lc->ColorFormat, p, c);
+        }
+}
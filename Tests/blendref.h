@@ -0,0 +1,36 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _BLENDREF_H_
+#define _BLENDREF_H_
+
+/*
+Per-channel reference of the alpha blending. The channels are kept as real
+numbers in the 0..255 range in R, G, B, A order, the source is a 0xAABBGGRR
+pixel with straight or premultiplied alpha.
+*/
+typedef double TREFPIXEL[4];
+
+extern void REF_ReadPixel(TCFORMAT Format, uint8_t *p, TREFPIXEL c);
+extern void REF_Blend(TREFPIXEL c, uint32_t Src, boolean Premul);
+extern void REF_WritePixel(TCFORMAT Format, uint8_t *p, TREFPIXEL c);
+extern double REF_Error(TCFORMAT Format, uint8_t *p, TREFPIXEL c);
+extern void REF_FillRectangleAlpha(pLCONTEXT lc, pRECT Rct, uint32_t Color);
+extern void REF_BlendBitmap(pLCONTEXT lc, pRECT Rct, pBITMAP Bitmap, TPOINT SrcPt);
+
+#endif /* _BLENDREF_H_ */
@@ -0,0 +1,261 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+TSCREEN  LCDScreen;
+THOSTLCD HostLCD;
+
+static uint8_t HostAlpha[LCDIF_NUMLAYERS] = {0xFF, 0xFF, 0xFF, 0xFF};
+
+/* The settings of the layer are written to the registers of the controller */
+static void HOST_WriteLayer(TVLINDEX Layer)
+{
+    HostLCD.LayerRect[Layer] = (LCDScreen.VLayer[Layer].Enabled) ? LCDIF_GetLayerScreenRect(Layer) : Rect(0, 0, -1, -1);
+    HostLCD.LayerAlpha[Layer] = HostAlpha[Layer];
+}
+
+/* LCD controller */
+boolean LCDIF_Initialize(void)
+{
+    return true;
+}
+
+void LCDIF_DisableInterface(void)
+{
+}
+
+boolean LCDIF_SetupLayer(TVLINDEX Layer, TPOINT Offset, uint32_t SizeX, uint32_t SizeY,
+                         TCFORMAT CFormat, uint8_t Alpha)
+{
+    pLCONTEXT lc;
+
+    if (Layer >= LCDIF_NUMLAYERS) return false;
+
+    lc = &LCDScreen.VLayer[Layer];
+    lc->Enabled = false;
+    lc->Initialized = false;
+    free(lc->FrameBuffer);
+    lc->FrameBuffer = NULL;
+
+    if (SizeX && SizeY && (CFormat < CF_NUM))
+    {
+        lc->LayerRgn = Rect(0, 0, SizeX - 1, SizeY - 1);
+        lc->LayerOffset = Offset;
+        lc->ColorFormat = CFormat;
+        lc->BPP = CFormatToBPP[CFormat];
+        lc->FrameBuffer = calloc(SizeX * SizeY, lc->BPP);
+        lc->Initialized = (lc->FrameBuffer != NULL);
+        HostAlpha[Layer] = ((CFormat == CF_ARGB8888) || (CFormat == CF_PARGB8888)) ? 0 : Alpha;
+    }
+    HOST_WriteLayer(Layer);
+
+    return lc->Initialized;
+}
+
+TRECT LCDIF_GetLayerScreenRect(TVLINDEX Layer)
+{
+    TRECT Rct;
+
+    if (Layer >= LCDIF_NUMLAYERS) return Rect(0, 0, -1, -1);
+
+    Rct = GDI_LocalToGlobalRct(&LCDScreen.VLayer[Layer].LayerRgn, &LCDScreen.VLayer[Layer].LayerOffset);
+    return GDI_GlobalToLocalRct(&Rct, &LCDScreen.ScreenOffset);
+}
+
+boolean LCDIF_SetLayerEnabled(TVLINDEX Layer, boolean Enabled, boolean UpdateScreen)
+{
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    if (LCDScreen.VLayer[Layer].Enabled != Enabled)
+    {
+        LCDScreen.VLayer[Layer].Enabled = Enabled;
+        if (UpdateScreen)
+        {
+            HOST_WriteLayer(Layer);
+            LCDIF_UpdateRectangle(LCDIF_GetLayerScreenRect(Layer));
+        }
+    }
+    return Enabled;
+}
+
+boolean LCDIF_MoveLayer(TVLINDEX Layer, int16_t dx, int16_t dy, boolean UpdateScreen)
+{
+    pLCONTEXT lc;
+    TRECT     OldRect;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    lc = &LCDScreen.VLayer[Layer];
+    if ((lc->LayerOffset.x + lc->LayerRgn.l + dx < 0) || (lc->LayerOffset.y + lc->LayerRgn.t + dy < 0))
+        return false;
+
+    OldRect = LCDIF_GetLayerScreenRect(Layer);
+    lc->LayerRgn.l += dx;
+    lc->LayerRgn.r += dx;
+    lc->LayerRgn.t += dy;
+    lc->LayerRgn.b += dy;
+    if (UpdateScreen) HOST_WriteLayer(Layer);
+    if (UpdateScreen && lc->Enabled)
+    {
+        LCDIF_UpdateRectangle(OldRect);
+        LCDIF_UpdateRectangle(LCDIF_GetLayerScreenRect(Layer));
+    }
+    return true;
+}
+
+boolean LCDIF_SetLayerOffset(TVLINDEX Layer, TPOINT Offset, boolean UpdateScreen)
+{
+    pLCONTEXT lc;
+    TRECT     OldRect;
+
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    lc = &LCDScreen.VLayer[Layer];
+    if ((Offset.x + lc->LayerRgn.l < 0) || (Offset.y + lc->LayerRgn.t < 0)) return false;
+
+    OldRect = LCDIF_GetLayerScreenRect(Layer);
+    lc->LayerOffset = Offset;
+    if (UpdateScreen) HOST_WriteLayer(Layer);
+    if (UpdateScreen && lc->Enabled)
+    {
+        LCDIF_UpdateRectangle(OldRect);
+        LCDIF_UpdateRectangle(LCDIF_GetLayerScreenRect(Layer));
+    }
+    return true;
+}
+
+boolean LCDIF_SetLayerAlpha(TVLINDEX Layer, uint8_t Alpha, boolean UpdateScreen)
+{
+    if ((Layer >= LCDIF_NUMLAYERS) || !LCDScreen.VLayer[Layer].Initialized) return false;
+
+    HostAlpha[Layer] = Alpha;
+    if (UpdateScreen) HOST_WriteLayer(Layer);
+    if (UpdateScreen && LCDScreen.VLayer[Layer].Enabled)
+        LCDIF_UpdateRectangle(LCDIF_GetLayerScreenRect(Layer));
+
+    return true;
+}
+
+uint8_t LCDIF_GetLayerAlpha(TVLINDEX Layer)
+{
+    return (Layer < LCDIF_NUMLAYERS) ? HostAlpha[Layer] : 0xFF;
+}
+
+boolean LCDIF_IsLayerOpaque(TVLINDEX Layer)
+{
+    return (Layer < LCDIF_NUMLAYERS) && LCDScreen.VLayer[Layer].Initialized &&
+           LCDScreen.VLayer[Layer].Enabled && (HostAlpha[Layer] == 0xFF);
+}
+
+void LCDIF_CommitLayers(void)
+{
+    uint32_t i;
+
+    for(i = 0; i < LCDIF_NUMLAYERS; i++) HOST_WriteLayer(i);
+}
+
+static TLCDQSTATUS HOST_QueueUpdate(TRECT Rct, boolean Wait, uint32_t *Fence)
+{
+    if (!GDI_ANDRectangles(&Rct, &LCDScreen.ScreenRgn)) return LQS_CLIPPED;
+    if (HostLCD.QueueSize && (HostLCD.Tail - HostLCD.Head >= HostLCD.QueueSize))
+    {
+        if (!Wait) return LQS_FULL;
+        HostLCD.Head++;                                                                             // The producer waits for one transfer
+    }
+
+    HostLCD.Updates++;
+    HostLCD.Pixels += (Rct.r - Rct.l + 1) * (Rct.b - Rct.t + 1);
+    HostLCD.Tail++;
+    if (!HostLCD.QueueSize) HostLCD.Head = HostLCD.Tail;
+    if (Fence != NULL) *Fence = HostLCD.Tail;
+
+    return LQS_QUEUED;
+}
+
+void LCDIF_UpdateRectangle(TRECT Rct)
+{
+    HOST_QueueUpdate(Rct, true, NULL);
+}
+
+void LCDIF_UpdateRectangleBlocked(pRECT Rct)
+{
+    if (Rct == NULL) return;
+
+    HOST_QueueUpdate(*Rct, true, NULL);
+    HostLCD.Head = HostLCD.Tail;
+}
+
+TLCDQSTATUS LCDIF_SubmitUpdate(TRECT Rct, void (*Handler)(uint32_t, void *), void *Object, uint32_t *Fence)
+{
+    return HOST_QueueUpdate(Rct, false, Fence);
+}
+
+uint32_t LCDIF_GetFence(void)
+{
+    return HostLCD.Tail;
+}
+
+boolean LCDIF_IsFenceReached(uint32_t Fence)
+{
+    return (int32_t)(HostLCD.Head - Fence) >= 0;
+}
+
+boolean LCDIF_IsTransferComplete(void)
+{
+    return HostLCD.Head == HostLCD.Tail;
+}
+
+void LCDIF_GetTransferStat(pLCDIFSTAT Stat, boolean Reset)
+{
+    if (Stat == NULL) return;
+
+    memset(Stat, 0x00, sizeof(TLCDIFSTAT));
+    Stat->Updates = HostLCD.Updates;
+}
+
+/* Host helpers */
+void HOST_SetupScreen(uint32_t SizeX, uint32_t SizeY)
+{
+    uint32_t i;
+
+    LCDScreen.ScreenRgn = Rect(0, 0, SizeX - 1, SizeY - 1);
+    LCDScreen.ScreenOffset = Point(0, 0);
+    LCDScreen.ScreenCount = 1;
+    for(i = 0; i < LCDIF_NUMLAYERS; i++)
+    {
+        if (GUIWinZOrder[i] == NULL) GUIWinZOrder[i] = DL_Create(0);
+    }
+    LCDIF_SetupLayer(LCDIF_LAYER0, Point(0, 0), SizeX, SizeY, CF_RGB565, 0xFF);
+    LCDIF_SetLayerEnabled(LCDIF_LAYER0, true, false);
+    LCDIF_CommitLayers();
+}
+
+void HOST_CompleteUpdates(void)
+{
+    HostLCD.Head = HostLCD.Tail;
+}
+
+void HOST_ResetLCDStat(void)
+{
+    HostLCD.Updates = 0;
+    HostLCD.Pixels = 0;
+}
@@ -0,0 +1,65 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _HOSTLCDIF_H_
+#define _HOSTLCDIF_H_
+
+/*
+The LCD driver and the ILI9341 driver built against the registers kept in memory.
+HOST_RunLCDIF() raises the interrupt of the controller in-line while its RUN bit
+is set, so the hardware drains the queue at once. The drivers are compiled into
+the program that includes this file, it is included by one source of the program.
+*/
+
+static uint8_t HostLCDIFRegs[0x10000];
+static uint8_t HostConfigRegs[0x1000];
+
+#undef  LCDIF_BASE
+#define LCDIF_BASE                  ((uintptr_t)HostLCDIFRegs)
+#undef  CONFIG_BASE
+#define CONFIG_BASE                 ((uintptr_t)HostConfigRegs)
+#define CFormatToBPP                LCDIFCFormatToBPP                                               // The copy of hostlib.c is used by GDI
+
+#include "lcdif.c"
+#include "ili9341.c"
+
+boolean NVIC_RegisterIRQ(uint32_t IRQ, void (*Handler)(void), uint8_t Sens, boolean Enable)
+{
+    return true;
+}
+
+boolean NVIC_UnregisterIRQ(uint32_t IRQ)
+{
+    return true;
+}
+
+void GPIO_Setup(uint32_t Pin, uint32_t Mode)
+{
+}
+
+/* The transfer of the loaded command is complete */
+static void HOST_RunLCDIF(void)
+{
+    while(LCDIF_START & LCDIF_RUN)
+    {
+        LCDIF_INTSTA = LCDIF_CPL;
+        LCDIF_ISR();
+    }
+}
+
+#endif /* _HOSTLCDIF_H_ */
@@ -0,0 +1,145 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include <time.h>
+#include "systemconfig.h"
+#include "hostlib.h"
+
+const uint8_t CFormatToBPP[] = {1, 2, 0, 3, 4, 4, 4};                                               // The table of the LCD driver
+
+int32_t  HostTicks;
+uint32_t HostFailures;
+
+static uint32_t HostSeed = 1;
+
+/* System */
+uint32_t DisableInterrupts(void)
+{
+    return 0;
+}
+
+void RestoreInterrupts(uint32_t Flags)
+{
+    (void)Flags;
+}
+
+int32_t USC_GetCurrentTicks(void)
+{
+    return HostTicks;
+}
+
+void USC_Pause_us(uint32_t us)
+{
+    HostTicks += us;
+}
+
+pTIMER LRT_Create(uint32_t Interval, pHANDLE Parent, void (*Handler)(pTIMER), TMRFLAGS Flags)
+{
+    pTIMER Timer = calloc(1, sizeof(TTIMER));
+
+    if (Timer != NULL)
+    {
+        Timer->Interval = Interval;
+        Timer->Parent = Parent;
+        Timer->Handler = Handler;
+        Timer->Flags = Flags;
+    }
+    return Timer;
+}
+
+boolean LRT_Start(pTIMER Timer)
+{
+    if (Timer == NULL) return false;
+    Timer->Flags |= TF_ENABLED;
+    Timer->StartTicks = HostTicks;
+
+    return true;
+}
+
+boolean LRT_Stop(pTIMER Timer)
+{
+    if (Timer == NULL) return false;
+    Timer->Flags &= ~TF_ENABLED;
+
+    return true;
+}
+
+boolean EM_PostEvent(TEVTYPE Type, void *Object, void *Param, uint32_t ParamSz)
+{
+    return false;
+}
+
+uint32_t EM_GetQueueDepth(uint32_t *Peak, boolean ResetPeak)
+{
+    if (Peak != NULL) *Peak = 0;
+
+    return 0;
+}
+
+size_t GetTotalUsedMemory(void)
+{
+    return 0;
+}
+
+void PMUBL_Initialize(void)
+{
+}
+
+boolean FT6236_Initialize(void)
+{
+    return true;
+}
+
+/* xorshift32, the tests are reproducible by the seed */
+uint32_t HOST_Random(void)
+{
+    HostSeed ^= HostSeed << 13;
+    HostSeed ^= HostSeed >> 17;
+    HostSeed ^= HostSeed << 5;
+
+    return HostSeed;
+}
+
+void HOST_SeedRandom(uint32_t Seed)
+{
+    HostSeed = (Seed) ? Seed : 1;
+}
+
+int32_t HOST_RandomRange(int32_t Min, int32_t Max)
+{
+    return Min + (int32_t)(HOST_Random() % (uint32_t)(Max - Min + 1));
+}
+
+/* Seconds of the monotonic clock */
+double HOST_Time(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int HOST_Result(const char *Name)
+{
+    if (HostFailures) printf("%s: %u failure(s)\n", Name, HostFailures);
+    else printf("%s: passed\n", Name);
+
+    return HostFailures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#ifndef _HOSTLIB_H_
+#define _HOSTLIB_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+Host model of the hardware the platform independent code runs on.
+The LCD controller keeps the layer contexts in LCDScreen like the real one,
+the updates sent to the screen are only counted. The updates are sent at once
+unless HostLCD.QueueSize is set, then they wait for HOST_CompleteUpdates().
+The layer settings changed without UpdateScreen reach the controller with LCDIF_CommitLayers().
+*/
+typedef struct tag_HOSTLCD
+{
+    uint32_t Updates;                                                                               // Updates sent to the screen
+    uint32_t Pixels;                                                                                // Pixels of these updates
+    uint32_t QueueSize;                                                                             // 0 - the updates are sent at once
+    uint32_t Head;
+    uint32_t Tail;
+    TRECT    LayerRect[LCDIF_NUMLAYERS];                                                            // Screen rectangles of the enabled layers
+    uint8_t  LayerAlpha[LCDIF_NUMLAYERS];                                                           // as the controller sees them
+} THOSTLCD, *pHOSTLCD;
+
+extern THOSTLCD HostLCD;
+extern int32_t  HostTicks;                                                                          // Value of USC_GetCurrentTicks() in us
+extern uint32_t HostFailures;
+
+#define CHECK(c, fmt, args...)      do\
+                                    {\
+                                        if (!(c))\
+                                        {\
+                                            HostFailures++;\
+                                            printf("%s:%d: " fmt "\n", __FILE__, __LINE__, ## args);\
+                                        }\
+                                    }\
+                                    while(0)
+
+extern void HOST_SetupScreen(uint32_t SizeX, uint32_t SizeY);
+extern void HOST_CompleteUpdates(void);
+extern void HOST_ResetLCDStat(void);
+extern uint32_t HOST_Random(void);
+extern void HOST_SeedRandom(uint32_t Seed);
+extern int32_t HOST_RandomRange(int32_t Min, int32_t Max);
+extern double HOST_Time(void);
+extern int HOST_Result(const char *Name);
+
+#endif /* _HOSTLIB_H_ */
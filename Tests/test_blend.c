@@ -0,0 +1,167 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+#include "blendref.h"
+
+/*
+Alpha blending kernels against the per-channel reference: the fills of
+GDI_FillRectangleAlphaX and the BM_BLEND blits of GDI_BitBltX, which use
+GDI_BlendRow565 and GDI_BlendRowPremul565 on RGB565 layers. Every blended
+pixel has to be within MAX_ERROR of the reference in the least significant
+bits of the layer format, the pixels outside of the rectangle must not change.
+Usage: test_blend [cases [seed]]
+*/
+
+#define LAYER_SX        37                                                                          // Odd width to get both pixel alignments
+#define LAYER_SY        24
+#define MAX_ERROR       2.0
+
+static const TCFORMAT LayerFormats[] = {CF_RGB565, CF_RGB888, CF_ARGB8888, CF_xRGB8888};
+
+static uint32_t CaseIndex;
+static double   MaxError[CF_NUM][3];                                                                // Fill, straight and premultiplied blit
+
+static uint8_t RandomAlpha(void)
+{
+    switch(HOST_Random() % 4)
+    {
+    case 0:
+        return 0;
+    case 1:
+        return 0xFF;
+    default:
+        return HOST_Random();
+    }
+}
+
+static uint32_t RandomPixel(uint32_t Alpha, boolean Premul)
+{
+    uint32_t Pixel = HOST_Random() & 0x00FFFFFF;
+
+    if (Premul)                                                                                     // Channels can not exceed the alpha
+        Pixel = ((Pixel & 0xFF) * Alpha / 255) | (((Pixel >> 8) & 0xFF) * Alpha / 255 << 8) |
+                (((Pixel >> 16) & 0xFF) * Alpha / 255 << 16);
+
+    return Pixel | (Alpha << 24);
+}
+
+static TRECT RandomLayerRect(void)
+{
+    int32_t l = HOST_RandomRange(0, LAYER_SX - 1), t = HOST_RandomRange(0, LAYER_SY - 1);
+
+    return Rect(l, t, HOST_RandomRange(l, LAYER_SX - 1), HOST_RandomRange(t, LAYER_SY - 1));
+}
+
+static void Compare(pLCONTEXT lc, uint8_t *Old, pRECT Rct, uint32_t Color, pBITMAP Bitmap, TPOINT SrcPt)
+{
+    uint32_t Kind = (Bitmap == NULL) ? 0 : (Bitmap->ColorFormat == CF_PARGB8888) ? 2 : 1;
+    int32_t  x, y;
+
+    for(y = 0; y < LAYER_SY; y++)
+        for(x = 0; x < LAYER_SX; x++)
+        {
+            uint32_t  Offset = (y * LAYER_SX + x) * lc->BPP;
+            uint8_t   *p = (uint8_t *)lc->FrameBuffer + Offset;
+            TREFPIXEL c;
+            double    Error;
+
+            if (!IsPointInRect(x, y, Rct))
+            {
+                CHECK(!memcmp(p, Old + Offset, lc->BPP), "case %u: pixel (%d,%d) outside of the rectangle changed",
+                      CaseIndex, x, y);
+                continue;
+            }
+            REF_ReadPixel(lc->ColorFormat, Old + Offset, c);
+            if (Bitmap != NULL)
+            {
+                uint32_t *s = Bitmap->Data;
+
+                Color = s[(SrcPt.y + y - Rct->t) * Bitmap->Width + SrcPt.x + x - Rct->l];
+            }
+            REF_Blend(c, Color, (Bitmap != NULL) && (Bitmap->ColorFormat == CF_PARGB8888));
+
+            Error = REF_Error(lc->ColorFormat, p, c);
+            if (Error > MaxError[lc->ColorFormat][Kind]) MaxError[lc->ColorFormat][Kind] = Error;
+            CHECK(Error <= MAX_ERROR, "case %u: format %u, %s 0x%08X, error %.2f LSB at (%d,%d)", CaseIndex,
+                  lc->ColorFormat, (Bitmap == NULL) ? "fill" : (Bitmap->ColorFormat == CF_PARGB8888) ?
+                  "premultiplied" : "straight", Color, Error, x, y);
+        }
+}
+
+static void TestCase(pLCONTEXT lc, uint8_t *Old)
+{
+    TRECT    Rct = RandomLayerRect();
+    uint32_t Size = LAYER_SX * LAYER_SY * lc->BPP, i;
+
+    for(i = 0; i < Size; i++) ((uint8_t *)lc->FrameBuffer)[i] = HOST_Random();
+    memcpy(Old, lc->FrameBuffer, Size);
+
+    if (HOST_Random() & 1)
+    {
+        uint32_t Color = RandomPixel(RandomAlpha(), false);
+
+        GDI_FillRectangleAlphaX(lc, &Rct, Color);
+        Compare(lc, Old, &Rct, Color, NULL, Point(0, 0));
+    }
+    else
+    {
+        static uint32_t Data[LAYER_SX * 2 * LAYER_SY * 2];
+        TBITMAP         Bitmap = {(HOST_Random() & 1) ? CF_PARGB8888 : CF_ARGB8888, LAYER_SX * 2, LAYER_SY * 2, 0, Data};
+        TPOINT          SrcPt = Point(HOST_RandomRange(0, LAYER_SX), HOST_RandomRange(0, LAYER_SY));
+        boolean         Constant = (HOST_Random() % 3) == 0;                                        // Some bitmaps have a constant alpha
+        uint32_t        Alpha = RandomAlpha();
+
+        for(i = 0; i < LAYER_SX * 2 * LAYER_SY * 2; i++)
+            Data[i] = RandomPixel((Constant) ? Alpha : RandomAlpha(), Bitmap.ColorFormat == CF_PARGB8888);
+        GDI_BitBltX(lc, &Rct, &Bitmap, SrcPt, BM_BLEND, 0);
+        Compare(lc, Old, &Rct, 0, &Bitmap, SrcPt);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t  Cases = (argc > 1) ? strtoul(argv[1], NULL, 0) : 4000;
+    uint32_t  Seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0x2020;
+    uint8_t   *Old = malloc(LAYER_SX * LAYER_SY * sizeof(uint32_t));
+    TLCONTEXT lc = {0};
+    uint32_t  i;
+
+    printf("test_blend: %u cases, seed 0x%X\n", Cases, Seed);
+    HOST_SeedRandom(Seed);
+
+    lc.LayerRgn = Rect(0, 0, LAYER_SX - 1, LAYER_SY - 1);
+    lc.FrameBuffer = malloc(LAYER_SX * LAYER_SY * sizeof(uint32_t));
+    for(CaseIndex = 0; (CaseIndex < Cases) && (HostFailures < 20); CaseIndex++)
+    {
+        lc.ColorFormat = LayerFormats[CaseIndex % (sizeof(LayerFormats) / sizeof(LayerFormats[0]))];
+        lc.BPP = CFormatToBPP[lc.ColorFormat];
+        TestCase(&lc, Old);
+    }
+    for(i = 0; i < sizeof(LayerFormats) / sizeof(LayerFormats[0]); i++)
+        printf("format %u: largest error %.2f LSB for fills, %.2f and %.2f LSB for straight and premultiplied blits\n",
+               LayerFormats[i], MaxError[LayerFormats[i]][0], MaxError[LayerFormats[i]][1], MaxError[LayerFormats[i]][2]);
+
+    free(lc.FrameBuffer);
+    free(Old);
+
+    return HOST_Result("test_blend");
+}
@@ -0,0 +1,144 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+/*
+Hidden regions of the layers. The dirty parts covered by an opaque layer above
+are not painted and do not keep the paint pending, they are painted only after
+the layer coverage is changed by the alpha, the offset or the enabling of the layer.
+The layer settings reach the controller with the paint pass. The pen is checked to pass through the blended layers without windows.
+*/
+
+#define SCREEN_SIZE     240
+#define LAYER_AREA      (SCREEN_SIZE * SCREEN_SIZE)
+
+/* Runs the paint passes until nothing is pending, returns the invalidated area of the first one. */
+static uint32_t PaintAll(const char *Name)
+{
+    TPAINTSTAT Stat;
+    uint32_t   Invalidated, Passes = 0;
+
+    GUI_GetPaintStat(&Stat, true);
+    do
+    {
+        GUI_ProcessPaint();
+        HOST_CompleteUpdates();
+        if (!Passes++)
+        {
+            GUI_GetPaintStat(&Stat, true);
+            Invalidated = Stat.InvalidatedPixels;
+        }
+    } while(GUI_IsPaintPending() && (Passes < 4));
+    CHECK(!GUI_IsPaintPending(), "%s: the paint is still pending after %u passes", Name, Passes);
+
+    return Invalidated;
+}
+
+/* Invalidates the whole bottom layer, it has to be hidden by the top one. */
+static void HideBottomLayer(const char *Name)
+{
+    TPAINTSTAT Stat;
+
+    GUI_GetPaintStat(&Stat, true);
+    GUI_InvalidateLayer(LCDIF_LAYER0, &LCDScreen.VLayer[LCDIF_LAYER0].LayerRgn);
+    GUI_ProcessPaint();
+    GUI_GetPaintStat(&Stat, true);
+    CHECK(Stat.CulledPixels == LAYER_AREA, "%s: %u pixels culled, expected %u", Name, Stat.CulledPixels, LAYER_AREA);
+    CHECK(!GUI_IsPaintPending(), "%s: the hidden region keeps the paint pending", Name);
+
+    GUI_ProcessPaint();
+    GUI_GetPaintStat(&Stat, true);
+    CHECK(!Stat.InvalidatedPixels, "%s: the hidden region is painted again", Name);
+}
+
+/* Paints the pending coverage change, Revealed is the expected area of the bottom layer painted. */
+static void CheckReveal(const char *Name, uint32_t Revealed)
+{
+    uint32_t Invalidated;
+
+    CHECK(GUI_IsPaintPending(), "%s: the coverage change is not pending", Name);
+    Invalidated = PaintAll(Name);
+    CHECK(Invalidated == Revealed, "%s: %u pixels invalidated, expected %u", Name, Invalidated, Revealed);
+    printf("%-32s %12u\n", Name, Invalidated);
+}
+
+int main(void)
+{
+    pWIN   Bottom, Top;
+    TPOINT Pen;
+
+    HOST_SetupScreen(SCREEN_SIZE, SCREEN_SIZE);
+    CHECK(LCDIF_SetupLayer(LCDIF_LAYER1, Point(0, 0), SCREEN_SIZE, SCREEN_SIZE, CF_RGB565, 0xFF),
+          "the top layer is not created");
+    Bottom = GUI_CreateWindow(NULL, Rect(0, 0, SCREEN_SIZE - 1, SCREEN_SIZE - 1), NULL, LCDIF_LAYER0, clNavy,
+                              GF_VISIBLE | GF_ENABLED);
+    Top = GUI_CreateWindow(NULL, Rect(0, 0, SCREEN_SIZE - 1, SCREEN_SIZE - 1), NULL, LCDIF_LAYER1, clGreen,
+                           GF_VISIBLE | GF_ENABLED);
+    CHECK((Bottom != NULL) && (Top != NULL), "windows are not created");
+    if (HostFailures) return HOST_Result("test_layers");
+
+    CHECK(GUI_SetLayerEnabled(LCDIF_LAYER1, true) && LCDScreen.VLayer[LCDIF_LAYER1].Enabled,
+          "the top layer is not enabled");
+    CHECK(HostLCD.LayerRect[LCDIF_LAYER1].r < 0, "the top layer is enabled on the screen before the paint pass");
+    GUI_InvalidateLayer(LCDIF_LAYER1, &LCDScreen.VLayer[LCDIF_LAYER1].LayerRgn);
+    PaintAll("initial paint");
+    CHECK(HostLCD.LayerRect[LCDIF_LAYER1].r == SCREEN_SIZE - 1, "the top layer is not enabled by the paint pass");
+    printf("%-32s %12s\n", "change", "invalidated");
+
+    HideBottomLayer("hidden, no change");
+    GUI_SetLayerAlpha(LCDIF_LAYER1, 0xFF);
+    CheckReveal("alpha 0xFF -> 0xFF", 0);
+    GUI_SetLayerAlpha(LCDIF_LAYER1, 0x80);
+    CheckReveal("alpha 0xFF -> 0x80", LAYER_AREA);
+
+    GUI_SetLayerAlpha(LCDIF_LAYER1, 0xFF);
+    PaintAll("alpha 0x80 -> 0xFF");
+    HideBottomLayer("hidden, opaque again");
+    GUI_SetLayerOffset(LCDIF_LAYER1, Point(SCREEN_SIZE / 2, 0));
+    CHECK(HostLCD.LayerRect[LCDIF_LAYER1].l == 0, "the top layer is moved on the screen before the paint pass");
+    CheckReveal("offset 0 -> 120", LAYER_AREA / 2);
+    CHECK(HostLCD.LayerRect[LCDIF_LAYER1].l == SCREEN_SIZE / 2, "the top layer is not moved by the paint pass");
+    GUI_SetLayerOffset(LCDIF_LAYER1, Point(SCREEN_SIZE / 4, 0));
+    CheckReveal("offset 120 -> 60", 0);
+    CHECK(GUI_SetLayerEnabled(LCDIF_LAYER1, false) && !LCDScreen.VLayer[LCDIF_LAYER1].Enabled,
+          "the top layer is not disabled");
+    CHECK(HostLCD.LayerRect[LCDIF_LAYER1].r >= 0, "the top layer is disabled on the screen before the paint pass");
+    CheckReveal("top layer disabled", LAYER_AREA / 2);
+    CHECK(HostLCD.LayerRect[LCDIF_LAYER1].r < 0, "the top layer is not disabled by the paint pass");
+
+    /* The pen passes through a blended layer without windows, like the debug overlay */
+    Pen = Point(10, 10);
+    CHECK(LCDIF_SetupLayer(LCDIF_LAYER3, Point(0, 0), SCREEN_SIZE / 2, SCREEN_SIZE / 2, CF_RGB565, 0xC0) &&
+          GUI_SetLayerEnabled(LCDIF_LAYER3, true), "the overlay layer is not created");
+    CHECK(GUI_GetWindowFromPoint(&Pen, NULL) == Bottom, "the blended layer without windows takes the pen");
+    GUI_SetLayerAlpha(LCDIF_LAYER3, 0xFF);
+    CHECK(GUI_GetWindowFromPoint(&Pen, NULL) == NULL, "the pen passes through the opaque layer");
+    GUI_SetLayerEnabled(LCDIF_LAYER3, false);
+    LCDIF_SetupLayer(LCDIF_LAYER3, Point(0, 0), 0, 0, CF_RGB565, 0xFF);
+    PaintAll("overlay hidden");
+
+    GUI_DestroyObject((pGUIHEADER)Top);
+    GUI_DestroyObject((pGUIHEADER)Bottom);
+    GUI_ProcessPaint();
+
+    return HOST_Result("test_layers");
+}
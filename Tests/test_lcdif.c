@@ -0,0 +1,135 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+#include "hostlcdif.h"
+
+/*
+Completions of the LCDIF command queue with the drivers of hostlcdif.h.
+The handlers are called from LCDIF_ProcessCompletions() only, in the submit order
+and once their updates are sent. A submit with a handler is refused while the ring
+of completions is full, so none is lost. An update interrupted by an unsolicited
+interrupt is sent again. The layer settings changed without UpdateScreen wait for
+LCDIF_CommitLayers(), so a running transfer does not see them.
+*/
+
+static uint32_t Calls;
+static uint32_t LastFence;
+static uint32_t OrderErrors;
+
+static void OnUpdateSent(uint32_t Fence, void *Object)
+{
+    if ((Fence != (uint32_t)(uintptr_t)Object) || (Calls && (Fence <= LastFence))) OrderErrors++;
+    LastFence = Fence;
+    Calls++;
+}
+
+/* Queues an update with the handler, its object is the expected fence. */
+static TLCDQSTATUS SubmitWithHandler(void)
+{
+    return LCDIF_SubmitUpdate(Rect(0, 0, 9, 9), OnUpdateSent, (void *)(uintptr_t)(LCDIF_GetFence() + 1), NULL);
+}
+
+/* One transfer of the controller is complete */
+static void CompleteOne(void)
+{
+    if (!(LCDIF_START & LCDIF_RUN)) return;
+
+    LCDIF_INTSTA = LCDIF_CPL;
+    LCDIF_ISR();
+}
+
+int main(void)
+{
+    uint32_t i, Queued = 0;
+    pLAYER   Layer;
+
+    CHECK(LCDIF_Initialize(), "the LCD interface is not initialized");
+    if (HostFailures) return HOST_Result("test_lcdif");
+
+    /* The hardware is stalled, nothing is reported until the updates are sent */
+    for(i = 0; i < 10; i++)
+    {
+        if (i & 1) LCDIF_UpdateRectangle(Rect(0, 0, 4, 4));
+        else Queued += (SubmitWithHandler() == LQS_QUEUED);
+    }
+    LCDIF_ProcessCompletions();
+    CHECK((Queued == 5) && !Calls, "%u handlers called before the updates are sent", Calls);
+
+    CompleteOne();
+    CompleteOne();
+    LCDIF_ProcessCompletions();
+    CHECK(Calls == 1, "%u handlers called after 2 updates are sent, expected 1", Calls);
+
+    HOST_RunLCDIF();
+    CHECK(Calls == 1, "the handlers are called by the ISR");
+    LCDIF_ProcessCompletions();
+    CHECK((Calls == 5) && !OrderErrors, "%u handlers called after the queue is drained, %u out of order",
+          Calls, OrderErrors);
+
+    /* The completions are not dispatched, the ring of them fills up */
+    Calls = 0;
+    for(i = 0; i < MAX_LCDQUEUE_SIZE; i++)
+    {
+        CHECK(SubmitWithHandler() == LQS_QUEUED, "the update %u with the handler is not queued", i);
+        HOST_RunLCDIF();
+    }
+    CHECK(SubmitWithHandler() == LQS_FULL, "the update is queued with the completions full");
+    CHECK(LCDIF_SubmitUpdate(Rect(0, 0, 9, 9), NULL, NULL, NULL) == LQS_QUEUED,
+          "the update without the handler is refused with the completions full");
+    HOST_RunLCDIF();
+    LCDIF_ProcessCompletions();
+    CHECK((Calls == MAX_LCDQUEUE_SIZE) && !OrderErrors, "%u handlers called, %u out of order", Calls, OrderErrors);
+    CHECK(SubmitWithHandler() == LQS_QUEUED, "the update with the handler is refused after the dispatch");
+    HOST_RunLCDIF();
+    LCDIF_ProcessCompletions();
+
+    /* The unsolicited interrupt leaves the update to be sent again */
+    LCDIF_UpdateRectangle(Rect(10, 20, 109, 69));
+    LCDIF_INTSTA = 0;
+    LCDIF_ISR();
+    CHECK((LCDIF_START & LCDIF_RUN) && (LCDIF_WROISIZE == (LCDIF_WROICOL(100) | LCDIF_WROIROW(50))) &&
+          !LCDIF_IsTransferComplete(), "the update is not sent again after an unsolicited interrupt");
+    HOST_RunLCDIF();
+    CHECK(LCDIF_IsTransferComplete(), "the queue is not drained");
+
+    /* The layer registers are written by the commit */
+    Layer = LCDIF_LAYER[LCDIF_LAYER1];
+    CHECK(LCDIF_SetupLayer(LCDIF_LAYER1, Point(0, 0), 16, 16, CF_RGB565, 0xFF), "the layer is not created");
+    LCDIF_SetLayerEnabled(LCDIF_LAYER1, true, false);
+    LCDIF_MoveLayer(LCDIF_LAYER1, 8, 4, false);
+    LCDIF_SetLayerAlpha(LCDIF_LAYER1, 0x80, false);
+    CHECK((LCDIF_GetLayerAlpha(LCDIF_LAYER1) == 0x80) && !LCDIF_IsLayerOpaque(LCDIF_LAYER1) &&
+          (LCDScreen.VLayer[LCDIF_LAYER1].LayerRgn.l == 8), "the layer settings are not kept");
+    CHECK(!(LCDIF_WROICON & LCDIF_L1EN) && (Layer->LCDIF_LWINOFFS == 0) && !(Layer->LCDIF_LWINCON & LCDIF_LALPHA_EN),
+          "the layer registers are written before the commit");
+    LCDIF_CommitLayers();
+    CHECK((LCDIF_WROICON & LCDIF_L1EN) && (Layer->LCDIF_LWINOFFS == (LCDIF_LWINOF_X(8) | LCDIF_LWINOF_Y(4))) &&
+          ((Layer->LCDIF_LWINCON & (LCDIF_LALPHA(0xFF) | LCDIF_LALPHA_EN)) == (LCDIF_LALPHA(0x80) | LCDIF_LALPHA_EN)),
+          "the layer registers are not written by the commit");
+    LCDIF_SetLayerOffset(LCDIF_LAYER1, Point(2, 2), true);
+    CHECK(Layer->LCDIF_LWINOFFS == (LCDIF_LWINOF_X(10) | LCDIF_LWINOF_Y(6)),
+          "the layer register is not written with the screen update");
+    HOST_RunLCDIF();
+    LCDIF_SetupLayer(LCDIF_LAYER1, Point(0, 0), 0, 0, CF_RGB565, 0xFF);
+
+    return HOST_Result("test_lcdif");
+}
@@ -0,0 +1,180 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+/*
+Moves of the frame buffer pixels. GDI_MoveRegion has to copy the overlapping parts
+of a region of several bands in the right order for every direction of the move,
+it is checked against the copy of the whole layer. The moved objects and layers
+do not change the frame buffer and the layer registers before the paint pass,
+the moves of one object and the scrolls of a list between the passes are copied once.
+*/
+
+#define SCREEN_SIZE     64
+#define LAYER_PIXELS    (SCREEN_SIZE * SCREEN_SIZE)
+
+static const int16_t RegionRects[][4] = {{4, 4, 27, 19}, {12, 12, 43, 35}, {30, 28, 55, 51}, {8, 40, 20, 58},
+                                          {46, 6, 60, 14}};
+
+static uint16_t Source[LAYER_PIXELS];
+static uint16_t Expected[LAYER_PIXELS];
+static uint16_t Painted[LAYER_PIXELS];
+
+static boolean IsSameRect(TRECT a, TRECT b)
+{
+    return (a.l == b.l) && (a.t == b.t) && (a.r == b.r) && (a.b == b.b);
+}
+
+static void CheckMoveRegion(pREGION Region, TPOINT dXY)
+{
+    uint16_t *FrameBuffer = LCDScreen.VLayer[LCDIF_LAYER0].FrameBuffer;
+    uint32_t Count, i, Errors = 0;
+    pRECT    Rects = GDI_GetRegionRects(Region, &Count);
+    int32_t  x, y;
+
+    for(i = 0; i < LAYER_PIXELS; i++) Source[i] = i;
+    memcpy(FrameBuffer, Source, sizeof(Source));
+    memcpy(Expected, Source, sizeof(Source));
+    for(; Count; Count--, Rects++)
+        for(y = Rects->t; y <= Rects->b; y++)
+            for(x = Rects->l; x <= Rects->r; x++)
+            {
+                int32_t sx = x - dXY.x, sy = y - dXY.y;
+
+                if ((sx >= 0) && (sx < SCREEN_SIZE) && (sy >= 0) && (sy < SCREEN_SIZE))
+                    Expected[y * SCREEN_SIZE + x] = Source[sy * SCREEN_SIZE + sx];
+            }
+
+    GDI_MoveRegion(LCDIF_LAYER0, Region, dXY);
+    for(i = 0; i < LAYER_PIXELS; i++) Errors += (FrameBuffer[i] != Expected[i]);
+    CHECK(!Errors, "move by (%d, %d): %u pixels differ from the copy", dXY.x, dXY.y, Errors);
+}
+
+/* Every item has its own color */
+static void DrawItem(pLISTVIEW List, uint32_t Index, pRECT ItemRect, pRECT Clip)
+{
+    GDI_FillRectangle(LCDIF_LAYER0, *Clip, Index * 0x0A1B3C);
+}
+
+/* Paints the moves and compares the frame buffer with a full repaint, returns the moved area. */
+static uint32_t PaintMoves(const char *Name)
+{
+    pLCONTEXT  lc = &LCDScreen.VLayer[LCDIF_LAYER0];
+    TPAINTSTAT Stat;
+
+    GUI_GetPaintStat(&Stat, true);
+    GUI_ProcessPaint();
+    GUI_GetPaintStat(&Stat, true);
+    memcpy(Painted, lc->FrameBuffer, sizeof(Painted));
+    GUI_InvalidateLayer(LCDIF_LAYER0, &lc->LayerRgn);
+    GUI_ProcessPaint();
+    CHECK(!memcmp(Painted, lc->FrameBuffer, sizeof(Painted)), "%s: the moved pixels differ from the repaint", Name);
+    printf("%-32s %12u\n", Name, Stat.MovedPixels);
+
+    return Stat.MovedPixels;
+}
+
+int main(void)
+{
+    static uint16_t Pixels[16 * 8];
+    TBITMAP         Bitmap = {CF_RGB565, 16, 8, 0, Pixels};
+    TREGION         Region = {0};
+    TRECT           Position;
+    pWIN            Win, Top;
+    pIMAGE          Image;
+    pLISTVIEW       List;
+    int32_t         dx, dy;
+    uint32_t        i;
+
+    HOST_SetupScreen(SCREEN_SIZE, SCREEN_SIZE);
+
+    /* The copy order of GDI_MoveRegion */
+    for(i = 0; i < sizeof(RegionRects) / sizeof(RegionRects[0]); i++)
+    {
+        Position = Rect(RegionRects[i][0], RegionRects[i][1], RegionRects[i][2], RegionRects[i][3]);
+        GDI_ADDRectToRegion(&Region, &Position);
+    }
+    for(dy = -5; dy <= 5; dy += 5)
+        for(dx = -5; dx <= 5; dx += 5)
+            if (dx || dy) CheckMoveRegion(&Region, Point(dx, dy));
+    GDI_FreeRegion(&Region);
+
+    /* The moves of the object are copied by the paint pass at once */
+    for(i = 0; i < 16 * 8; i++) Pixels[i] = i * 517;
+    Win = GUI_CreateWindow(NULL, Rect(0, 0, SCREEN_SIZE - 1, SCREEN_SIZE - 1), NULL, LCDIF_LAYER0, clNavy,
+                           GF_VISIBLE | GF_ENABLED);
+    Image = (Win != NULL) ? GUI_CreateImage((pGUIHEADER)Win, Rect(10, 10, 29, 19), &Bitmap, AH_LEFT | AV_TOP,
+                                            clBlack, GF_VISIBLE) : NULL;
+    List = (Win != NULL) ? GUI_CreateListView((pGUIHEADER)Win, Rect(40, 0, 63, 63), NULL, 10, 50, NULL, clWhite,
+                                              clBlack, GF_VISIBLE | GF_ENABLED) : NULL;
+    CHECK((Image != NULL) && (List != NULL), "the image or the list is not created");
+    if (HostFailures) return HOST_Result("test_move");
+
+    GUI_InvalidateLayer(LCDIF_LAYER0, &LCDScreen.VLayer[LCDIF_LAYER0].LayerRgn);
+    GUI_ProcessPaint();
+    memcpy(Source, LCDScreen.VLayer[LCDIF_LAYER0].FrameBuffer, sizeof(Source));
+    printf("%-32s %12s\n", "change", "moved");
+
+    Position = Rect(13, 12, 32, 21);
+    GUI_SetObjectPosition(&Image->Head, &Position);
+    Position = Rect(16, 14, 35, 23);
+    GUI_SetObjectPosition(&Image->Head, &Position);
+    CHECK(!memcmp(Source, LCDScreen.VLayer[LCDIF_LAYER0].FrameBuffer, sizeof(Source)),
+          "the frame buffer is changed before the paint pass");
+    CHECK(GUI_IsPaintPending(), "the move is not pending");
+    CHECK(PaintMoves("image moved twice") == 20 * 10, "the moves of the image are not copied once");
+
+    List->OnDrawItem = DrawItem;
+    GUI_Invalidate(&List->Head, NULL);
+    GUI_ProcessPaint();
+    memcpy(Source, LCDScreen.VLayer[LCDIF_LAYER0].FrameBuffer, sizeof(Source));
+    GUI_ScrollListView(List, 3);
+    GUI_ScrollListView(List, 7);
+    CHECK(!memcmp(Source, LCDScreen.VLayer[LCDIF_LAYER0].FrameBuffer, sizeof(Source)),
+          "the frame buffer is changed by the scroll before the paint pass");
+    CHECK(PaintMoves("list scrolled twice") == 24 * (64 - 7), "the scrolls of the list are not copied once");
+
+    /* The layer of the window is moved by the paint pass */
+    CHECK(LCDIF_SetupLayer(LCDIF_LAYER1, Point(0, 0), SCREEN_SIZE / 2, SCREEN_SIZE / 2, CF_RGB565, 0xFF) &&
+          GUI_SetLayerEnabled(LCDIF_LAYER1, true), "the top layer is not created");
+    Top = GUI_CreateWindow(NULL, Rect(0, 0, SCREEN_SIZE / 2 - 1, SCREEN_SIZE / 2 - 1), NULL, LCDIF_LAYER1, clGreen,
+                           GF_VISIBLE | GF_ENABLED);
+    CHECK(Top != NULL, "the top window is not created");
+    if (HostFailures) return HOST_Result("test_move");
+    GUI_ProcessPaint();
+
+    Position = Rect(8, 4, SCREEN_SIZE / 2 + 7, SCREEN_SIZE / 2 + 3);
+    GUI_SetObjectPosition(&Top->Head, &Position);
+    Position = LCDIF_GetLayerScreenRect(LCDIF_LAYER1);
+    CHECK(IsSameRect(Position, Rect(8, 4, SCREEN_SIZE / 2 + 7, SCREEN_SIZE / 2 + 3)), "the window is not moved by the layer");
+    CHECK(IsSameRect(HostLCD.LayerRect[LCDIF_LAYER1], Rect(0, 0, SCREEN_SIZE / 2 - 1, SCREEN_SIZE / 2 - 1)),
+          "the layer is moved on the screen before the paint pass");
+    CHECK(PaintMoves("window moved by the layer") == 0, "the window pixels are copied");
+    CHECK(IsSameRect(HostLCD.LayerRect[LCDIF_LAYER1], Position), "the layer is not moved by the paint pass");
+
+    GUI_DestroyObject((pGUIHEADER)Top);
+    GUI_DestroyObject((pGUIHEADER)Win);
+    GUI_ProcessPaint();
+    LCDIF_SetupLayer(LCDIF_LAYER1, Point(0, 0), 0, 0, CF_RGB565, 0xFF);
+
+    return HOST_Result("test_move");
+}
@@ -0,0 +1,419 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+/*
+Region operations are checked against a per-pixel bitmap oracle on random inputs.
+The banded form of a region is unique for its set of pixels, so the expected
+rectangles are rebuilt from the oracle bitmap and compared one by one: this checks
+the coverage, the band order and that adjacent bands and spans are merged.
+Usage: test_region [cases [seed]]
+*/
+
+#define MAP_ORIGIN      (-16)                                                                       // Coordinate of the first map pixel
+#define MAP_SIZE        96
+#define RND_MIN         (-8)                                                                        // Random rectangles lie in RND_MIN..RND_MAX
+#define RND_MAX         55
+#define MAX_SHIFT       8                                                                           // Translation keeps the regions on the map
+#define MAX_RECTS       (MAP_SIZE * MAP_SIZE / 2)
+
+typedef uint8_t TMAP[MAP_SIZE][MAP_SIZE];
+
+static TRECT    ExpRects[MAX_RECTS];
+static uint32_t CaseIndex;
+
+static void MAP_Clear(TMAP m)
+{
+    memset(m, 0x00, sizeof(TMAP));
+}
+
+static boolean MAP_IsRectValid(pRECT r)
+{
+    return (r->l <= r->r) && (r->t <= r->b);
+}
+
+static void MAP_SetRect(TMAP m, pRECT r, uint8_t v)
+{
+    int32_t x, y;
+
+    if (!MAP_IsRectValid(r)) return;
+    for(y = r->t; y <= r->b; y++)
+        for(x = r->l; x <= r->r; x++)
+            m[y - MAP_ORIGIN][x - MAP_ORIGIN] = v;
+}
+
+static void MAP_AND(TMAP Dst, TMAP a, TMAP b)
+{
+    uint32_t i;
+
+    for(i = 0; i < sizeof(TMAP); i++) ((uint8_t *)Dst)[i] = ((uint8_t *)a)[i] & ((uint8_t *)b)[i];
+}
+
+static void MAP_ADD(TMAP Dst, TMAP a, TMAP b)
+{
+    uint32_t i;
+
+    for(i = 0; i < sizeof(TMAP); i++) ((uint8_t *)Dst)[i] = ((uint8_t *)a)[i] | ((uint8_t *)b)[i];
+}
+
+static void MAP_SUB(TMAP Dst, TMAP a, TMAP b)
+{
+    uint32_t i;
+
+    for(i = 0; i < sizeof(TMAP); i++) ((uint8_t *)Dst)[i] = ((uint8_t *)a)[i] & !((uint8_t *)b)[i];
+}
+
+static void MAP_Translate(TMAP m, int32_t dx, int32_t dy)
+{
+    TMAP    tmp;
+    int32_t x, y;
+
+    MAP_Clear(tmp);
+    for(y = 0; y < MAP_SIZE; y++)
+        for(x = 0; x < MAP_SIZE; x++)
+            if (m[y][x]) tmp[y + dy][x + dx] = 1;
+    memcpy(m, tmp, sizeof(TMAP));
+}
+
+static boolean MAP_IsEmpty(TMAP m)
+{
+    uint32_t i;
+
+    for(i = 0; i < sizeof(TMAP); i++) if (((uint8_t *)m)[i]) return false;
+
+    return true;
+}
+
+/* The canonical banded form: spans of equal rows are merged into bands. */
+static uint32_t MAP_ToRects(TMAP m)
+{
+    uint32_t Count = 0, Band = 0, BandCount = 0;
+    int32_t  x, y;
+
+    for(y = 0; y < MAP_SIZE; y++)
+    {
+        uint32_t First = Count, n, i;
+
+        for(x = 0; x < MAP_SIZE; x++)
+        {
+            if (!m[y][x]) continue;
+
+            ExpRects[Count].l = ExpRects[Count].r = x + MAP_ORIGIN;
+            ExpRects[Count].t = ExpRects[Count].b = y + MAP_ORIGIN;
+            while((x + 1 < MAP_SIZE) && m[y][x + 1]) ExpRects[Count].r = ++x + MAP_ORIGIN;
+            Count++;
+        }
+        n = Count - First;
+        if (!n) continue;
+
+        if (BandCount == n && (ExpRects[Band].b == y + MAP_ORIGIN - 1))
+        {
+            for(i = 0; i < n; i++)
+                if ((ExpRects[Band + i].l != ExpRects[First + i].l) ||
+                        (ExpRects[Band + i].r != ExpRects[First + i].r)) break;
+            if (i == n)
+            {
+                for(i = 0; i < n; i++) ExpRects[Band + i].b++;
+                Count = First;
+                continue;
+            }
+        }
+        Band = First;
+        BandCount = n;
+    }
+    return Count;
+}
+
+static void CheckRegion(pREGION Rgn, TMAP m, const char *Op)
+{
+    uint32_t Count, Expected, i;
+    pRECT    Rects = GDI_GetRegionRects(Rgn, &Count);
+
+    Expected = MAP_ToRects(m);
+    CHECK(Count == Expected, "case %u, %s: %u rectangles, expected %u", CaseIndex, Op, Count, Expected);
+    if (Count != Expected) return;
+
+    CHECK(GDI_IsRegionEmpty(Rgn) == (Count == 0), "case %u, %s: empty flag", CaseIndex, Op);
+    for(i = 0; i < Count; i++)
+    {
+        if (memcmp(&Rects[i], &ExpRects[i], sizeof(TRECT)))
+        {
+            CHECK(false, "case %u, %s: rectangle %u is (%d,%d,%d,%d), expected (%d,%d,%d,%d)",
+                  CaseIndex, Op, i, Rects[i].l, Rects[i].t, Rects[i].r, Rects[i].b,
+                  ExpRects[i].l, ExpRects[i].t, ExpRects[i].r, ExpRects[i].b);
+            return;
+        }
+    }
+    if (Count)
+    {
+        TRECT Box = ExpRects[0];
+
+        for(i = 1; i < Count; i++)
+        {
+            Box.l = min(Box.l, ExpRects[i].l);
+            Box.r = max(Box.r, ExpRects[i].r);
+            Box.b = max(Box.b, ExpRects[i].b);
+        }
+        CHECK(!memcmp(&Box, &Rgn->Extent, sizeof(TRECT)), "case %u, %s: wrong extent", CaseIndex, Op);
+    }
+}
+
+/* Mostly valid rectangles of different sizes, sometimes an empty one (l > r or t > b). */
+static TRECT RandomRect(void)
+{
+    int32_t Max = (HOST_Random() & 1) ? 8 : RND_MAX - RND_MIN;
+    int32_t l = HOST_RandomRange(RND_MIN, RND_MAX);
+    int32_t t = HOST_RandomRange(RND_MIN, RND_MAX);
+    int32_t r = l + HOST_RandomRange(0, Max);
+    int32_t b = t + HOST_RandomRange(0, Max);
+
+    r = min(r, RND_MAX);
+    b = min(b, RND_MAX);
+
+    if ((HOST_Random() % 20) == 0)
+    {
+        if (HOST_Random() & 1) r = l - 1;
+        else b = t - HOST_RandomRange(1, 4);
+    }
+    return Rect(l, t, r, b);
+}
+
+/* Builds a random region by the rectangle operations and checks every step. */
+static void RandomRegion(pREGION Rgn, TMAP m)
+{
+    uint32_t n = HOST_RandomRange(0, 12);
+
+    GDI_InitRegion(Rgn);
+    MAP_Clear(m);
+    while(n--)
+    {
+        TRECT   Rct = RandomRect();
+        boolean Res;
+
+        if ((HOST_Random() % 10) < 7)
+        {
+            Res = GDI_ADDRectToRegion(Rgn, &Rct);
+            MAP_SetRect(m, &Rct, 1);
+            CheckRegion(Rgn, m, "ADDRectToRegion");
+        }
+        else
+        {
+            Res = GDI_SUBRectFromRegion(Rgn, &Rct);
+            MAP_SetRect(m, &Rct, 0);
+            CheckRegion(Rgn, m, "SUBRectFromRegion");
+        }
+        CHECK(Res == !MAP_IsEmpty(m), "case %u: rectangle operation result", CaseIndex);
+    }
+}
+
+typedef boolean (*TREGIONOP)(pREGION, pREGION, pREGION);
+typedef void (*TMAPOP)(TMAP, TMAP, TMAP);
+
+static void TestRegionOp(const char *Name, TREGIONOP RgnOp, TMAPOP MapOp)
+{
+    static TMAP ma, mb, md, me;
+    TREGION     a, b, d;
+    boolean     Res;
+    uint32_t    Alias = HOST_Random() % 5;
+
+    RandomRegion(&a, ma);
+    RandomRegion(&b, mb);
+    RandomRegion(&d, md);                                                                           // The storage of the destination is reused
+
+    switch(Alias)
+    {
+    case 0:                                                                                         // d = a op b
+    case 1:
+        Res = RgnOp(&d, &a, &b);
+        MapOp(me, ma, mb);
+        CheckRegion(&d, me, Name);
+        CheckRegion(&a, ma, "unchanged source a");
+        CheckRegion(&b, mb, "unchanged source b");
+        break;
+    case 2:                                                                                         // a = a op b
+        Res = RgnOp(&a, &a, &b);
+        MapOp(me, ma, mb);
+        CheckRegion(&a, me, Name);
+        CheckRegion(&b, mb, "unchanged source b");
+        break;
+    case 3:                                                                                         // b = a op b
+        Res = RgnOp(&b, &a, &b);
+        MapOp(me, ma, mb);
+        CheckRegion(&b, me, Name);
+        CheckRegion(&a, ma, "unchanged source a");
+        break;
+    default:                                                                                        // a = a op a
+        Res = RgnOp(&a, &a, &a);
+        MapOp(me, ma, ma);
+        CheckRegion(&a, me, Name);
+        break;
+    }
+    CHECK(Res == !MAP_IsEmpty(me), "case %u, %s: result %d", CaseIndex, Name, Res);
+
+    GDI_FreeRegion(&a);
+    GDI_FreeRegion(&b);
+    GDI_FreeRegion(&d);
+}
+
+static void TestRegionMisc(void)
+{
+    static TMAP ma, mb;
+    TREGION     a, b;
+    TRECT       Rct = RandomRect();
+    int32_t     dx = HOST_RandomRange(-MAX_SHIFT, MAX_SHIFT);
+    int32_t     dy = HOST_RandomRange(-MAX_SHIFT, MAX_SHIFT);
+    boolean     Res;
+
+    RandomRegion(&a, ma);
+    RandomRegion(&b, mb);
+
+    Res = GDI_CopyRegion(&b, &a);
+    CHECK(Res, "case %u: CopyRegion failed", CaseIndex);
+    CheckRegion(&b, ma, "CopyRegion");
+
+    Res = GDI_ANDRegionWithRect(&a, &Rct);
+    MAP_Clear(mb);
+    MAP_SetRect(mb, &Rct, 1);
+    MAP_AND(ma, ma, mb);
+    CheckRegion(&a, ma, "ANDRegionWithRect");
+    CHECK(Res == !MAP_IsEmpty(ma), "case %u: ANDRegionWithRect result", CaseIndex);
+
+    GDI_TranslateRegion(&a, dx, dy);
+    MAP_Translate(ma, dx, dy);
+    CheckRegion(&a, ma, "TranslateRegion");
+
+    Res = GDI_SetRegionRect(&a, &Rct);
+    MAP_Clear(ma);
+    MAP_SetRect(ma, &Rct, 1);
+    CheckRegion(&a, ma, "SetRegionRect");
+    CHECK(Res == MAP_IsRectValid(&Rct), "case %u: SetRegionRect result", CaseIndex);
+
+    GDI_FreeRegion(&a);
+    GDI_FreeRegion(&b);
+}
+
+/* Adds the rectangles of the list to the map, checks that they do not overlap. */
+static void MAP_AddList(TMAP m, pDLIST List, boolean Disjoint, const char *Op)
+{
+    pDLITEM Item = DL_GetFirstItem(List);
+    int32_t x, y;
+
+    for(; Item != NULL; Item = DL_GetNextItem(Item))
+    {
+        pRECT r = Item->Data;
+
+        CHECK(MAP_IsRectValid(r), "case %u, %s: empty rectangle in the list", CaseIndex, Op);
+        for(y = r->t; y <= r->b; y++)
+            for(x = r->l; x <= r->r; x++)
+            {
+                if (Disjoint && m[y - MAP_ORIGIN][x - MAP_ORIGIN])
+                {
+                    CHECK(false, "case %u, %s: overlapping rectangles", CaseIndex, Op);
+                    return;
+                }
+                m[y - MAP_ORIGIN][x - MAP_ORIGIN] = 1;
+            }
+    }
+}
+
+static void TestRectangles(void)
+{
+    static TMAP ma, mb, me, mr;
+    TRECT       a = RandomRect(), b = RandomRect(), tmp, Res;
+    TPOINT      Offset = Point(HOST_RandomRange(-100, 100), HOST_RandomRange(-100, 100));
+    pDLIST      List;
+    boolean     Valid = MAP_IsRectValid(&a) && MAP_IsRectValid(&b);
+
+    MAP_Clear(ma);
+    MAP_Clear(mb);
+    MAP_SetRect(ma, &a, 1);
+    MAP_SetRect(mb, &b, 1);
+
+    MAP_AND(me, ma, mb);
+    CHECK(IsRectsOverlaps(&a, &b) == !MAP_IsEmpty(me), "case %u: IsRectsOverlaps", CaseIndex);
+    tmp = a;
+    if (GDI_ANDRectangles(&tmp, &b))
+    {
+        MAP_Clear(mr);
+        MAP_SetRect(mr, &tmp, 1);
+        CHECK(!memcmp(mr, me, sizeof(TMAP)), "case %u: ANDRectangles", CaseIndex);
+    }
+    else CHECK(MAP_IsEmpty(me), "case %u: ANDRectangles missed the overlap", CaseIndex);
+
+    Res = GDI_LocalToGlobalRct(&a, NULL);
+    CHECK(!memcmp(&Res, &a, sizeof(TRECT)), "case %u: LocalToGlobalRct without offset", CaseIndex);
+    Res = GDI_GlobalToLocalRct(&a, NULL);
+    CHECK(!memcmp(&Res, &a, sizeof(TRECT)), "case %u: GlobalToLocalRct without offset", CaseIndex);
+    tmp = GDI_LocalToGlobalRct(&a, &Offset);
+    Res = GDI_GlobalToLocalRct(&tmp, &Offset);
+    CHECK(!memcmp(&Res, &a, sizeof(TRECT)) && (tmp.l == a.l + Offset.x) && (tmp.b == a.b + Offset.y),
+          "case %u: rectangle conversion round trip", CaseIndex);
+
+    if (!Valid) return;                                                                             // The list functions expect valid rectangles
+
+    List = GDI_SUBRectangles(&a, &b);
+    MAP_SUB(me, ma, mb);
+    MAP_Clear(mr);
+    MAP_AddList(mr, List, true, "SUBRectangles");
+    CHECK(!memcmp(mr, me, sizeof(TMAP)), "case %u: SUBRectangles coverage", CaseIndex);
+    DL_Delete(List, true);
+
+    tmp = a;                                                                                        // May be replaced by b
+    List = GDI_ADDRectangles(&tmp, &b);
+    MAP_ADD(me, ma, mb);
+    MAP_Clear(mr);
+    MAP_AddList(mr, List, true, "ADDRectangles");
+    CHECK(!memcmp(mr, me, sizeof(TMAP)), "case %u: ADDRectangles coverage", CaseIndex);
+    DL_Delete(List, true);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t Cases = (argc > 1) ? strtoul(argv[1], NULL, 0) : 20000;
+    uint32_t Seed = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0x2020;
+
+    printf("test_region: %u cases, seed 0x%X\n", Cases, Seed);
+    HOST_SeedRandom(Seed);
+
+    for(CaseIndex = 0; (CaseIndex < Cases) && (HostFailures < 20); CaseIndex++)
+    {
+        switch(CaseIndex % 5)
+        {
+        case 0:
+            TestRegionOp("ANDRegions", GDI_ANDRegions, MAP_AND);
+            break;
+        case 1:
+            TestRegionOp("ADDRegions", GDI_ADDRegions, MAP_ADD);
+            break;
+        case 2:
+            TestRegionOp("SUBRegions", GDI_SUBRegions, MAP_SUB);
+            break;
+        case 3:
+            TestRegionMisc();
+            break;
+        default:
+            TestRectangles();
+            break;
+        }
+    }
+    return HOST_Result("test_region");
+}
@@ -0,0 +1,213 @@
+// This is an independent project of an individual developer. Dear PVS-Studio, please check it.
+// PVS-Studio Static Code Analyzer for C, C++ and C#: http://www.viva64.com
+/*
+* This file is part of the DZ09 project.
+*
+* Copyright (C) 2020 AJScorp
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; version 2 of the License.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+* General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+#include "systemconfig.h"
+#include "hostlib.h"
+
+/*
+Paint cost of the widget state changes. After every change the painted frame
+buffer is compared with a full repaint of the layer, so the invalidated area
+has to cover all changed pixels, and the invalidated area is checked against
+the area the widget is expected to invalidate for the change.
+*/
+
+#define SCREEN_SIZE     240
+#define FONT_HEIGHT     7
+#define CHANGED_BOX     0xFFFFFFFF                                                                  // The bound is the box of the changed pixels
+
+static const uint16_t GlyphWidths[] = {5, 9, 3};                                                    // 'A', 'B', 'C'
+
+static uint8_t       GlyphData[3][FONT_HEIGHT * 2];
+static BFC_CHARINFO  Glyphs[3];
+static BFC_FONT_PROP FontProp;
+static BFC_FONT      Font;
+static uint16_t      Before[SCREEN_SIZE * SCREEN_SIZE];
+static uint16_t      Painted[SCREEN_SIZE * SCREEN_SIZE];
+
+static void CreateFont(void)
+{
+    uint32_t i, j;
+
+    for(i = 0; i < 3; i++)
+    {
+        for(j = 0; j < FONT_HEIGHT * 2; j++) GlyphData[i][j] = HOST_Random();
+        Glyphs[i].Width = GlyphWidths[i];
+        Glyphs[i].DataSize = ((GlyphWidths[i] + 7) / 8) * FONT_HEIGHT;
+        Glyphs[i].p.pData8 = GlyphData[i];
+    }
+    FontProp.FirstChar = 'A';
+    FontProp.LastChar = 'C';
+    FontProp.pFirstCharInfo = Glyphs;
+    Font.FontType = FONTTYPE_PROP | DATALENGTH_8;
+    Font.FontHeight = FONT_HEIGHT;
+    Font.Baseline = FONT_HEIGHT - 1;
+    Font.p.pProp = &FontProp;
+}
+
+static uint32_t GetTextWidth(wchar_t *String)
+{
+    uint32_t Width = 0;
+
+    while(*String) Width += GlyphWidths[*String++ - 'A'];
+
+    return Width;
+}
+
+static uint32_t RepaintLayer(void)
+{
+    TPAINTSTAT Stat;
+
+    GUI_ProcessPaint();
+    GUI_GetPaintStat(&Stat, true);
+
+    return Stat.InvalidatedPixels;
+}
+
+/* Paints the pending change and checks its cost, MinArea..MaxArea is the expected invalidated area. */
+static void CheckChange(const char *Name, uint32_t MinArea, uint32_t MaxArea)
+{
+    pLCONTEXT lc = &LCDScreen.VLayer[LCDIF_LAYER0];
+    uint16_t  *FrameBuffer = lc->FrameBuffer;
+    TRECT     Box = Rect(SCREEN_SIZE, SCREEN_SIZE, -1, -1);
+    uint32_t  Invalidated, Changed = 0;
+    int32_t   x, y;
+
+    Invalidated = RepaintLayer();
+    memcpy(Painted, FrameBuffer, sizeof(Painted));
+    GUI_InvalidateLayer(LCDIF_LAYER0, &lc->LayerRgn);
+    RepaintLayer();
+    CHECK(!memcmp(Painted, FrameBuffer, sizeof(Painted)), "%s: not all changed pixels are invalidated", Name);
+
+    for(y = 0; y < SCREEN_SIZE; y++)
+        for(x = 0; x < SCREEN_SIZE; x++)
+        {
+            if (Before[y * SCREEN_SIZE + x] == FrameBuffer[y * SCREEN_SIZE + x]) continue;
+
+            Changed++;
+            Box.l = min(Box.l, x);
+            Box.t = min(Box.t, y);
+            Box.r = max(Box.r, x);
+            Box.b = max(Box.b, y);
+        }
+    if (MaxArea == CHANGED_BOX)
+        MaxArea = (Changed) ? (Box.r - Box.l + 5) * (Box.b - Box.t + 5) : 0;                        // Grown by 2 pixels for the rounding
+
+    CHECK(Invalidated >= Changed, "%s: %u pixels invalidated, %u changed", Name, Invalidated, Changed);
+    CHECK((Invalidated >= MinArea) && (Invalidated <= MaxArea), "%s: %u pixels invalidated, expected %u..%u",
+          Name, Invalidated, MinArea, MaxArea);
+    printf("%-24s %10u %12u\n", Name, Changed, Invalidated);
+
+    memcpy(Before, FrameBuffer, sizeof(Before));
+}
+
+int main(void)
+{
+    static const uint16_t ArcValues[] = {1, 5, 24, 25, 26, 50, 63, 75, 99, 100, 37, 0, 100};
+    static uint16_t       Pixels[16 * 8];
+    TBITMAP               Wide = {CF_RGB565, 16, 8, 0, Pixels}, Narrow = {CF_RGB565, 8, 8, 0, Pixels};
+    pWIN                  Win;
+    pLABEL                Label;
+    pBUTTON               Button;
+    pIMAGE                Image;
+    pPROGRESS             Bar, Arc;
+    TPENEVENT             Pen = {0};
+    uint32_t              i, ClientArea;
+    char                  Name[32];
+
+    HOST_SeedRandom(0x2020);
+    HOST_SetupScreen(SCREEN_SIZE, SCREEN_SIZE);
+    CreateFont();
+    for(i = 0; i < 16 * 8; i++) Pixels[i] = i * 517;
+
+    Win = GUI_CreateWindow(NULL, Rect(0, 0, SCREEN_SIZE - 1, SCREEN_SIZE - 1), NULL, LCDIF_LAYER0, clNavy,
+                           GF_VISIBLE | GF_ENABLED);
+    Label = GUI_CreateLabel((pGUIHEADER)Win, Rect(10, 10, 109, 29), &Font, L"ABC", AH_CENTER | AV_CENTER,
+                            clWhite, clBlack, GF_VISIBLE);
+    Button = GUI_CreateButton((pGUIHEADER)Win, Rect(10, 40, 89, 69), &Font, L"CAB", clWhite, clBlue,
+                              GF_VISIBLE | GF_ENABLED | GF_FRAMED);
+    Image = GUI_CreateImage((pGUIHEADER)Win, Rect(10, 80, 49, 99), &Wide, AH_CENTER | AV_CENTER, clBlack, GF_VISIBLE);
+    Bar = GUI_CreateProgress((pGUIHEADER)Win, Rect(10, 110, 209, 119), PS_BAR, 100, clLime, clGray, clBlack,
+                             GF_VISIBLE);
+    Arc = GUI_CreateProgress((pGUIHEADER)Win, Rect(120, 130, 219, 229), PS_ARC, 100, clLime, clGray, clBlack,
+                             GF_VISIBLE);
+    CHECK((Label != NULL) && (Button != NULL) && (Image != NULL) && (Bar != NULL) && (Arc != NULL),
+          "widgets are not created");
+    if (HostFailures) return HOST_Result("test_widgets");
+
+    GUI_InvalidateLayer(LCDIF_LAYER0, &LCDScreen.VLayer[LCDIF_LAYER0].LayerRgn);
+    RepaintLayer();
+    memcpy(Before, LCDScreen.VLayer[LCDIF_LAYER0].FrameBuffer, sizeof(Before));
+    printf("%-24s %10s %12s\n", "change", "changed", "invalidated");
+
+    /* Label: the old and the new text rectangles */
+    GUI_SetLabelText(Label, L"ABC");
+    CheckChange("label, same text", 0, 0);
+    GUI_SetLabelText(Label, L"AB");
+    CheckChange("label, shorter text", 1, GetTextWidth(L"ABC") * FONT_HEIGHT);
+    GUI_SetLabelText(Label, L"ABCABCAB");
+    CheckChange("label, longer text", 1, GetTextWidth(L"ABCABCAB") * FONT_HEIGHT);
+
+    /* Button: the client area without the frame */
+    ClientArea = (80 - 2) * (30 - 2);
+    Pen.PXY = Point(20, 50);
+    GUI_OnPenPressed(&Pen);
+    CheckChange("button, pressed", ClientArea, ClientArea);
+    CHECK(Button->Pressed, "the button is not pressed");
+    Pen.PXY = Point(200, 200);
+    GUI_OnPenMoved(&Pen);
+    CheckChange("button, pen left it", ClientArea, ClientArea);
+    CHECK(!Button->Pressed, "the button is still pressed");
+    Pen.PXY = Point(201, 200);
+    GUI_OnPenMoved(&Pen);
+    CheckChange("button, pen moved", 0, 0);
+    GUI_OnPenReleased(&Pen);
+    CheckChange("button, pen released", 0, 0);
+    GUI_SetButtonText(Button, L"CA");
+    CheckChange("button, text", 1, GetTextWidth(L"CAB") * FONT_HEIGHT);
+
+    /* Image: the old and the new bitmap rectangles */
+    GUI_SetImageBitmap(Image, &Narrow);
+    CheckChange("image, smaller bitmap", 16 * 8, 16 * 8);
+    GUI_SetImageBitmap(Image, &Narrow);
+    CheckChange("image, content changed", 8 * 8, 8 * 8);
+
+    /* Progress bar: the strip between the values, 2 pixels per percent */
+    GUI_SetProgressValue(Bar, 10);
+    CheckChange("bar, 0 -> 10", 20 * 10, 20 * 10);
+    GUI_SetProgressValue(Bar, 11);
+    CheckChange("bar, 10 -> 11", 2 * 10, 2 * 10);
+    GUI_SetProgressValue(Bar, 11);
+    CheckChange("bar, same value", 0, 0);
+    GUI_SetProgressValue(Bar, 0);
+    CheckChange("bar, 11 -> 0", 22 * 10, 22 * 10);
+
+    /* Progress ring: the bounding rectangle of the changed sector */
+    for(i = 0; i < sizeof(ArcValues) / sizeof(ArcValues[0]); i++)
+    {
+        sprintf(Name, "ring, %u -> %u", Arc->Value, ArcValues[i]);
+        GUI_SetProgressValue(Arc, ArcValues[i]);
+        CheckChange(Name, 1, CHANGED_BOX);
+    }
+
+    GUI_DestroyObject((pGUIHEADER)Win);
+    GUI_ProcessPaint();
+
+    return HOST_Result("test_widgets");
+}